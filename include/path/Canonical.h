@@ -6,10 +6,101 @@
 
 #include <path/Strings.h>
 #include <string>
+#include <string_view>
+#include <vector>
+#include <iterator>
 #include <iosfwd>
 
 namespace path
 {
+// Forward declarations
+class Canonical;
+class RulesBase;
+
+/**
+ * @class ComponentView path/Canonical.h
+ * A read-only view of the components in a Canonical.
+ *
+ * Each element is returned as a std::string_view that refers
+ * directly into the Canonical so no strings are copied.  This
+ * works the same whether or not the Canonical is packed().  The
+ * view is only valid as long as the Canonical is unchanged.
+ */
+class ComponentView
+{
+public:
+    /// Iterate through each component
+    class const_iterator
+    {
+    public:
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef std::string_view                value_type;
+        typedef std::ptrdiff_t                  difference_type;
+        typedef const std::string_view *        pointer;
+        typedef std::string_view                reference;
+
+        /// Create an iterator at index
+        const_iterator(const Canonical *canon, size_t index);
+        /// Return the component
+        std::string_view operator*() const;
+        /// Prefix increment
+        const_iterator &operator++();
+        /// Postfix increment
+        const_iterator operator++(int);
+        /// Prefix decrement
+        const_iterator &operator--();
+        /// Postfix decrement
+        const_iterator operator--(int);
+        /// Move n components forward
+        const_iterator &operator+=(difference_type n);
+        /// Move n components back
+        const_iterator &operator-=(difference_type n);
+        /// Return an iterator n components forward
+        const_iterator operator+(difference_type n) const;
+        /// Return an iterator n components back
+        const_iterator operator-(difference_type n) const;
+        /// Number of components between two iterators
+        difference_type operator-(const const_iterator &op2) const;
+        /// Return the component n forward
+        std::string_view operator[](difference_type n) const;
+        /// Comparison
+        bool operator==(const const_iterator &op2) const;
+        /// Comparison
+        bool operator!=(const const_iterator &op2) const;
+        /// Comparison
+        bool operator<(const const_iterator &op2) const;
+        /// Comparison
+        bool operator>(const const_iterator &op2) const;
+        /// Comparison
+        bool operator<=(const const_iterator &op2) const;
+        /// Comparison
+        bool operator>=(const const_iterator &op2) const;
+    private:
+        const Canonical *   m_canon;    ///< Canonical being viewed
+        size_t              m_index;    ///< Current component
+    };
+    /// Construct a view of canon
+    explicit ComponentView(const Canonical &canon);
+    /// Return the number of components
+    size_t size() const;
+    /// Return true if there are no components
+    bool empty() const;
+    /// Return a specific component
+    std::string_view operator[](size_t index) const;
+    /// Return the last component; must not be empty()
+    std::string_view back() const;
+    /// First component
+    const_iterator begin() const;
+    /// One past the last component
+    const_iterator end() const;
+private:
+    const Canonical *m_canon;   ///< Canonical being viewed
+};
+
+/// Return an iterator n components after iter
+ComponentView::const_iterator operator+(ComponentView::const_iterator::difference_type n,
+                                        const ComponentView::const_iterator &iter);
+
 /**
  * @class Canonical path/Canonical.h
  * Represents a Path in a standard form.
@@ -20,6 +111,16 @@ namespace path
  * each component.
  *
  * This is used to convert from one RulesBase type to another.
+ *
+ * Normally each component is kept as a separate std::string.  When
+ * creating a large number of paths (e.g. traversing a directory
+ * hierarchy) this can be expensive so setPacked() switches to keeping
+ * all the components in a single buffer with an array of offsets.
+ * This is preserved when copied so a Path created from a packed
+ * Canonical produces packed children with add().  Use view(),
+ * component() and size() to examine a packed Canonical without
+ * converting it back; components() still works but the non-const
+ * version unpacks the Canonical and the const one returns a copy.
  */
 class Canonical
 {
@@ -28,6 +129,8 @@ public:
     Canonical();
     /// Copy constructor
     Canonical(const Canonical &copy);
+    /// Move constructor
+    Canonical(Canonical &&copy) noexcept;
     /// Construct with basics but no path
     //Canonical(const std::string &protocol, const std::string &host, const std::string &extra);
     /// Copy but with new path
@@ -47,6 +150,8 @@ public:
 
     /// Assignment operator
     Canonical &operator=(const Canonical & op2);
+    /// Move assignment operator
+    Canonical &operator=(Canonical &&op2) noexcept;
 
     /// Copy the protocol, host, and extra without changing drive or components
     Canonical & setInfo(const Canonical &canon);
@@ -72,17 +177,48 @@ public:
 
     /// Add another component to the end
     Canonical & add(const std::string &dir);
+    /// Add another component to the end, moving dir
+    Canonical & add(std::string &&dir);
+    /// Add another component to the end
+    Canonical & add(std::string_view dir);
+    /// Add another component to the end
+    Canonical & add(const char *dir);
+    /// Append a string to the last component
+    Canonical & extendLast(std::string_view append);
+    /// Remove the last component
+    Canonical & removeLast();
 
     /// Return reference; you can change this.
     Strings &components();
-    /// Return const reference for const object
-    const Strings &components() const;
+    /// Return a copy for const object; see view()
+    Strings components() const;
+    /// Return a view of the components that does not copy them
+    ComponentView view() const;
+    /// Return a single component
+    std::string_view component(size_t index) const;
+    /// Return number of components
+    size_t size() const;
+
+    /// Keep all the components in a single buffer
+    Canonical & setPacked(bool packed);
+    /// Return if components are kept in a single buffer
+    bool packed() const;
+
+    /// Set the rules known not to need quoting for any component
+    Canonical & setPlain(const RulesBase *rules);
+    /// Return the rules that don't need to quote any component; may be NULL
+    const RulesBase *plain() const;
 
     /// Set if this is an absolute path
     Canonical & setAbs(bool abs);
     /// Return if this is an absolute path
     bool    abs() const;
 
+    /// Return a hash of all the values
+    size_t hash() const;
+    /// Compare all the values; returns <0, 0 or >0
+    int compare(const Canonical &op2) const;
+
 protected:
     /**
      * Gives the protocol (http, ftp, file, unc, etc).  May be empty.
@@ -96,16 +232,36 @@ protected:
      * Each individual path component.
      *
      * The raw components (e.g. environment varables are not expaned) are stored.
+     * Empty when packed().
      */
-    Strings m_components;
+    Strings         m_components;
+    bool            m_packed;   ///< Components are in m_buffer
+    /// All the components concatenated together when packed()
+    std::string     m_buffer;
+    /// Offset in m_buffer of the end of each component when packed()
+    std::vector<unsigned int>   m_ends;
+    /**
+     * No component needs RulesBase::quote() for these rules.
+     * Set when parsed by RulesBase::canonical() and kept as long as
+     * added components don't need quoting either.  May be NULL.
+     */
+    const RulesBase *   m_plain;
+
+private:
+    /// Copy m_components into m_buffer
+    void pack();
+    /// Copy m_buffer into m_components
+    void unpack();
 
 };
-}
 /// Print this out for debugging purposes!
 std::ostream& operator<<(std::ostream &out, const path::Canonical &canon);
 /// Return true if these two Cannoical objects are the same values
 bool operator==(const path::Canonical &op1, const path::Canonical &op2);
 /// Return true if these tow Canonical objects are different values
 bool operator!=(const path::Canonical &op1, const path::Canonical &op2);
+/// Order Canonical objects by their values (see Canonical::compare())
+bool operator<(const path::Canonical &op1, const path::Canonical &op2);
+}
 
 #endif // !defined(_PATH_CANNONICAL_H_)
@@ -0,0 +1,96 @@
+/**
+ * @file DirEntries.h
+ */
+#ifndef _PATH_DIRENTRIES_H_
+#define _PATH_DIRENTRIES_H_
+
+#include <path/NodeInfo.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace path {
+
+/**
+ * @class DirEntry path/DirEntries.h
+ * A single entry returned by SysBase::readdir().
+ *
+ * The name refers to memory owned by the DirEntries it came from
+ * and is only valid until that is cleared or read into again.
+ * It is always followed by a '\0' so name.data() can be passed
+ * to the SysBase calls that take a const char *.
+ */
+struct DirEntry
+{
+    /// The name within the directory (not the full path)
+    std::string_view    name;
+    /// The type if the system reported it; otherwise NodeInfo::UNKNOWN
+    NodeInfo::Type      type;
+    /// The inode number; 0 if not known
+    uint64_t            inode;
+};
+
+/**
+ * @class DirEntries path/DirEntries.h
+ * The contents of a directory as returned by SysBase::readdir().
+ *
+ * All the names are kept in one buffer so reading a directory
+ * does not allocate anything per entry.  Reuse the same
+ * DirEntries for each directory to avoid allocating at all
+ * once the buffer is large enough.
+ */
+class DirEntries
+{
+public:
+    /// How sort() orders the entries
+    enum SortOrder
+    {
+        UNSORTED,               ///< The order they were read
+        BYTEWISE,               ///< By the bytes of the name, like strcmp()
+        NATURAL                 ///< Runs of digits by their value, so "a9" before "a10"
+    };
+
+    /// Default constructor
+    DirEntries();
+    /// Destructor
+    ~DirEntries();
+
+    /// Return the number of entries
+    size_t size() const;
+    /// Return true if there are no entries
+    bool empty() const;
+    /// Return a single entry
+    DirEntry operator[](size_t index) const;
+    /// Remove all entries but keep the memory
+    void clear();
+    /// Fill in order with the index of each entry in sorted order
+    void sort(std::vector<size_t> &order, SortOrder how) const;
+
+    /// Add an entry, copying name
+    void add(std::string_view name, NodeInfo::Type type, uint64_t inode);
+    /// Return room for bytes more bytes at offset used()
+    char *space(size_t bytes);
+    /// Mark bytes returned by space() as used
+    void commit(size_t bytes);
+    /// Return the number of bytes used in the buffer
+    size_t used() const;
+    /// Add an entry whose name is already at offset in the buffer
+    void addAt(size_t offset, size_t length, NodeInfo::Type type, uint64_t inode);
+
+private:
+    /// Where to find a single entry
+    struct Record
+    {
+        size_t          m_offset;   ///< Start of the name in m_buffer
+        size_t          m_length;   ///< Length of the name
+        NodeInfo::Type  m_type;     ///< Type of the entry
+        uint64_t        m_inode;    ///< Inode number
+    };
+    std::vector<char>   m_buffer;   ///< The names (and anything else read)
+    size_t              m_used;     ///< Bytes of m_buffer in use
+    std::vector<Record> m_records;  ///< One per entry
+};
+}
+#endif /* _PATH_DIRENTRIES_H_ */
@@ -17,7 +17,11 @@ class Exception : public std::exception
 public:
     Exception();
     Exception(const std::string &mesage);
+    Exception(const Exception &copy) = default;
+    Exception(Exception &&copy) = default;
     virtual ~Exception() throw();
+    Exception &operator=(const Exception &op2) = default;
+    Exception &operator=(Exception &&op2) = default;
     virtual const char *what() const throw();
 protected:
     std::string     m_message;
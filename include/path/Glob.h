@@ -1,7 +1,11 @@
 #ifndef _PATH_GLOB_H_
 #define _PATH_GLOB_H_
 
+#include <path/Refcount.h>
+
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace path {
 /**
@@ -14,6 +18,32 @@ namespace path {
  * - test.?
  * - *[0-9].cpp
  * - *[^0-9].cpp
+ * - ^*.o (anything not ending in .o)
+ *
+ * The pattern is compared against the whole word:
+ * - '*' matches any number of characters, including none
+ * - '?' matches any single character
+ * - [...] matches one of the characters listed; a-z is a range,
+ *   a leading '^' or '!' matches anything not listed and a leading
+ *   ']' is part of the list.  An unclosed '[' is a regular character.
+ * - {a,b,...} matches any of the comma separated patterns, which
+ *   may themselves contain any of the above.  "{}" is a regular pair
+ *   of characters.
+ * - '^' at the start matches anything the rest of the pattern doesn't
+ * - '\\' makes the next character a regular one
+ *
+ * Like csh, a '{' without a matching '}' is an error; compile()
+ * returns false and nothing matches.
+ *
+ * The pattern is compiled into a deterministic automaton when
+ * the Glob is constructed.  Bytes the pattern treats alike share
+ * one column of its transition table so matching is one table
+ * lookup per byte of the word without any backtracking.  Before
+ * that, a word is checked for the regular characters the pattern
+ * ends with and the longest run of them in the middle, like the
+ * ".log" of "*.log" or "_backup_" of "*_backup_*", so most words
+ * that don't match are rejected without reading all of them.  Copies
+ * share the compiled pattern.
  */
 class Glob
 {
@@ -24,19 +54,38 @@ public:
     Glob (const Glob &copy);
     /// Destructor
     ~Glob();
-    /// Compile pattern (done automatically)
+    /// Assignment operator
+    Glob &operator=(const Glob &op2);
+    /// Compile pattern (done automatically); false if it is malformed
     bool compile();
     /// Compare against pattern
-    bool match (const std::string &word);
+    bool match (const std::string &word) const;
+    /// Compare against pattern
+    bool match (std::string_view word) const;
+    /// Compare against pattern
+    bool match (const char *word) const;
+    /// Return the pattern this was constructed with
+    const std::string &pattern() const;
 private:
+    friend class GlobSet;
+    /// Match any of patterns, giving up if it would be bigger than limit
+    Glob (const std::vector<std::string> &patterns, size_t limit);
+    /// Compile patterns into m_compiled
+    bool build(const std::vector<std::string> &patterns, bool negate, bool emit, size_t limit);
+    /// Add the index of each of the patterns that matched word
+    size_t matchAll(std::string_view word, std::vector<size_t> &which) const;
+    /// Return the number of states less the dead one
+    size_t rows() const;
+    /// Split classes by the bytes pattern tells apart; return how many
+    static unsigned refine(const std::string &pattern, unsigned char classes[256]);
     /// Implements state for pattern matching
     struct Pattern;
+    /// Put the states that can't be left first
+    static void sinksFirst(Pattern &p);
     /// The original pattern
     std::string     m_pattern;
-    /// The pattern turned into a FSA
-    Pattern *       m_compiled;
-
-
+    /// The pattern turned into a FSA; NULL if it is malformed
+    Refcount<Pattern> m_compiled;
 };
 }
 
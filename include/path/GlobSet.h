@@ -0,0 +1,97 @@
+/**
+ * @file GlobSet.h
+ */
+#ifndef _PATH_GLOBSET_H_
+#define _PATH_GLOBSET_H_
+
+#include <path/Glob.h>
+#include <path/HashTable.h>
+
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace path {
+/**
+ * @class GlobSet path/GlobSet.h
+ * Matches a word against many Glob patterns at once and
+ * reports which of them matched.
+ *
+ * Instead of trying each pattern in turn, the patterns are
+ * compiled together into one automaton so a word is read once
+ * no matter how many patterns there are.  Patterns of the form
+ * "*.ext" (a '*' followed only by regular characters) skip the
+ * automaton altogether; each suffix of the word that could be
+ * one of them is looked up in a hash table.  Patterns starting
+ * with '^' are matched one at a time.
+ *
+ * If the combined automaton would be too big, the patterns are
+ * split into groups that are each compiled on their own.
+ *
+ * match() compiles the patterns the first time after add(), so
+ * call compile() before sharing a GlobSet between threads.  After
+ * that match() only reads it and any number of threads can call
+ * it at once, as long as none of them calls add().
+ *
+ * @code
+ * GlobSet  rules;
+ * rules.add("*.o");        // 0
+ * rules.add("*.[ch]");     // 1
+ * rules.add("core");       // 2
+ * std::vector<size_t> which;
+ * rules.match("main.c", which);    // which is { 1 }
+ * @endcode
+ */
+class GlobSet
+{
+public:
+    /// An empty set that matches nothing
+    GlobSet();
+    /// Copy constructor
+    GlobSet(const GlobSet &copy);
+    /// Destructor
+    ~GlobSet();
+    /// Assignment operator
+    GlobSet &operator=(const GlobSet &op2);
+    /// Add a pattern; false if it is malformed and wasn't added
+    bool add(const std::string &pattern);
+    /// Return the number of patterns
+    size_t size() const;
+    /// Return one of the patterns
+    const std::string &pattern(size_t index) const;
+    /// Compile the patterns (done by match(); call before sharing between threads)
+    void compile();
+    /// Return true if any of the patterns match word
+    bool match(std::string_view word);
+    /// Add the index of each pattern that matches word to which
+    size_t match(std::string_view word, std::vector<size_t> &which);
+private:
+    /// Split the patterns into groups that should each fit in s_maxTable
+    void pack(const std::vector<size_t> &indexes);
+    /// Compile patterns[first, last) into one or more groups
+    void group(const std::vector<size_t> &indexes, size_t first, size_t last);
+    /// Rebuild m_suffixes from m_patterns
+    void indexSuffixes();
+
+    /// Every pattern added
+    std::vector<std::string>    m_patterns;
+    /// Number of states each of m_patterns has on its own
+    std::vector<size_t>         m_rows;
+    /// True once compile() has been called since the last add()
+    bool                        m_compiled;
+    /// Suffix of each "*.ext" pattern, a view into m_patterns, to the patterns with it
+    HashMap<std::string_view, std::vector<size_t> > m_suffixes;
+    /// The different lengths of suffix in m_suffixes
+    std::vector<size_t>         m_suffixLengths;
+    /// Patterns compiled together
+    std::vector<Glob>           m_groups;
+    /// Index in m_patterns of each pattern in each of m_groups
+    std::vector<std::vector<size_t> > m_groupIndexes;
+    /// Patterns starting with '^' and their index
+    std::vector<std::pair<Glob, size_t> > m_negated;
+    /// Most entries in the table of a group
+    static const size_t         s_maxTable;
+};
+}
+#endif /* _PATH_GLOBSET_H_ */
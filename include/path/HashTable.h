@@ -0,0 +1,441 @@
+/**
+ * @file HashTable.h
+ */
+#ifndef _PATH_HASHTABLE_H_
+#define _PATH_HASHTABLE_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace path {
+
+/**
+ * @class HashTable path/HashTable.h
+ *
+ * An open addressing hash table used to implement HashSet and HashMap.
+ *
+ * The entries are kept contiguously in insertion order (until something
+ * is erased) so iterating is the same as iterating over a std::vector.
+ * A separate, power of two sized array of slots is searched with
+ * linear probing.  Each slot holds the index of an entry plus part of
+ * its hash so most mismatches are rejected without looking at the
+ * entry itself.  Erasing moves the last entry into the hole and
+ * shifts slots back instead of leaving tombstones.
+ *
+ * Inserting or erasing invalidates iterators and references.
+ *
+ * @param Key The type of the key
+ * @param Entry The type stored; either Key or a std::pair with Key first
+ * @param KeyOf Function object returning the Key of an Entry
+ * @param Hash Function object returning the hash of a Key
+ * @param Equal Function object comparing two Keys
+ */
+template<typename Key, typename Entry, typename KeyOf, typename Hash, typename Equal>
+class HashTable
+{
+public:
+    /// What is stored
+    typedef Entry   value_type;
+    /// Iterate over the entries
+    typedef typename std::vector<Entry>::iterator iterator;
+    /// Iterate over the entries, const version
+    typedef typename std::vector<Entry>::const_iterator const_iterator;
+
+    /// Default constructor
+    HashTable();
+
+    /// Return the number of entries
+    size_t size() const;
+    /// Return true if there are no entries
+    bool empty() const;
+    /// Remove all the entries
+    void clear();
+    /// Make room for count entries without growing
+    void reserve(size_t count);
+
+    /// Return the first entry
+    iterator begin();
+    /// Return the first entry, const version
+    const_iterator begin() const;
+    /// Return the end of the entries
+    iterator end();
+    /// Return the end of the entries, const version
+    const_iterator end() const;
+
+    /// Return the entry with key or end()
+    iterator find(const Key &key);
+    /// Return the entry with key or end(), const version
+    const_iterator find(const Key &key) const;
+    /// Return 1 if key is present, 0 otherwise
+    size_t count(const Key &key) const;
+    /// Remove the entry with key; return number removed
+    size_t erase(const Key &key);
+
+protected:
+    /// Add entry unless its key is already present
+    std::pair<iterator, bool> insertEntry(const Entry &entry);
+
+private:
+    /// Where an entry is found in m_entries
+    struct Slot
+    {
+        unsigned int    m_index;    ///< Index in m_entries plus 1; 0 is empty
+        unsigned int    m_tag;      ///< Low bits of the hash
+    };
+    /// Return the slot holding key or the empty slot where it would go
+    size_t findSlot(const Key &key, size_t hash) const;
+    /// Return the slot refering to entry index
+    size_t slotOf(size_t index) const;
+    /// Rebuild m_slots with capacity slots
+    void rehash(size_t capacity);
+
+    std::vector<Entry>  m_entries;  ///< The entries
+    std::vector<size_t> m_hashes;   ///< Hash of each entry in m_entries
+    std::vector<Slot>   m_slots;    ///< Power of two sized probe table
+    Hash                m_hash;     ///< Calculates hashes
+    Equal               m_equal;    ///< Compares keys
+    KeyOf               m_keyOf;    ///< Gets the key from an entry
+};
+
+/// Returns the entry itself as the key
+template<typename Key>
+struct HashSetKey
+{
+    /// Return entry
+    const Key &operator()(const Key &entry) const
+    {
+        return entry;
+    }
+};
+
+/// Returns the first of a pair as the key
+template<typename Key, typename Value>
+struct HashMapKey
+{
+    /// Return entry.first
+    const Key &operator()(const std::pair<Key, Value> &entry) const
+    {
+        return entry.first;
+    }
+};
+
+/**
+ * @class HashSet path/HashTable.h
+ *
+ * A set of unique keys using HashTable.  Don't change the keys
+ * while they are in the set.
+ */
+template<typename Key, typename Hash = std::hash<Key>, typename Equal = std::equal_to<Key> >
+class HashSet : public HashTable<Key, Key, HashSetKey<Key>, Hash, Equal>
+{
+public:
+    /// The implementation
+    typedef HashTable<Key, Key, HashSetKey<Key>, Hash, Equal> Table;
+
+    /// Add key; the bool is false if it was already present
+    std::pair<typename Table::iterator, bool> insert(const Key &key)
+    {
+        return this->insertEntry(key);
+    }
+};
+
+/**
+ * @class HashMap path/HashTable.h
+ *
+ * Maps unique keys to values using HashTable.  Each entry is
+ * a std::pair of the key and value.  Don't change the first
+ * of a pair while it is in the map.
+ */
+template<typename Key, typename Value, typename Hash = std::hash<Key>, typename Equal = std::equal_to<Key> >
+class HashMap : public HashTable<Key, std::pair<Key, Value>, HashMapKey<Key, Value>, Hash, Equal>
+{
+public:
+    /// The implementation
+    typedef HashTable<Key, std::pair<Key, Value>, HashMapKey<Key, Value>, Hash, Equal> Table;
+
+    /// Add entry; the bool is false if the key was already present
+    std::pair<typename Table::iterator, bool> insert(const std::pair<Key, Value> &entry)
+    {
+        return this->insertEntry(entry);
+    }
+    /// Return the value for key, adding a default one if needed
+    Value &operator[](const Key &key)
+    {
+        typename Table::iterator iter = this->find(key);
+        if (iter == this->end())
+            iter = this->insertEntry(std::make_pair(key, Value())).first;
+        return iter->second;
+    }
+};
+
+/**
+ * Creates an empty table.  Nothing is allocated until the
+ * first insert.
+ */
+template<typename Key, typename Entry, typename KeyOf, typename Hash, typename Equal>
+HashTable<Key, Entry, KeyOf, Hash, Equal>::HashTable()
+    : m_entries(),
+      m_hashes(),
+      m_slots(),
+      m_hash(),
+      m_equal(),
+      m_keyOf()
+{
+}
+
+/**
+ * @return The number of entries
+ */
+template<typename Key, typename Entry, typename KeyOf, typename Hash, typename Equal>
+size_t HashTable<Key, Entry, KeyOf, Hash, Equal>::size() const
+{
+    return m_entries.size();
+}
+
+/**
+ * @return True if there are no entries
+ */
+template<typename Key, typename Entry, typename KeyOf, typename Hash, typename Equal>
+bool HashTable<Key, Entry, KeyOf, Hash, Equal>::empty() const
+{
+    return m_entries.empty();
+}
+
+/**
+ * Removes all the entries but keeps the memory.
+ */
+template<typename Key, typename Entry, typename KeyOf, typename Hash, typename Equal>
+void HashTable<Key, Entry, KeyOf, Hash, Equal>::clear()
+{
+    m_entries.clear();
+    m_hashes.clear();
+    Slot    empty = { 0, 0 };
+    std::fill(m_slots.begin(), m_slots.end(), empty);
+}
+
+/**
+ * Grow so count entries can be added without rehashing.
+ *
+ * @param count The number of entries
+ */
+template<typename Key, typename Entry, typename KeyOf, typename Hash, typename Equal>
+void HashTable<Key, Entry, KeyOf, Hash, Equal>::reserve(size_t count)
+{
+    m_entries.reserve(count);
+    m_hashes.reserve(count);
+    // Keep the load factor at or below 3/4
+    size_t  capacity = 8;
+    while (capacity * 3 < count * 4)
+        capacity *= 2;
+    if (capacity > m_slots.size())
+        rehash(capacity);
+}
+
+/**
+ * @return Iterator to the first entry
+ */
+template<typename Key, typename Entry, typename KeyOf, typename Hash, typename Equal>
+typename HashTable<Key, Entry, KeyOf, Hash, Equal>::iterator
+HashTable<Key, Entry, KeyOf, Hash, Equal>::begin()
+{
+    return m_entries.begin();
+}
+
+/**
+ * @return Iterator to the first entry
+ */
+template<typename Key, typename Entry, typename KeyOf, typename Hash, typename Equal>
+typename HashTable<Key, Entry, KeyOf, Hash, Equal>::const_iterator
+HashTable<Key, Entry, KeyOf, Hash, Equal>::begin() const
+{
+    return m_entries.begin();
+}
+
+/**
+ * @return Iterator past the last entry
+ */
+template<typename Key, typename Entry, typename KeyOf, typename Hash, typename Equal>
+typename HashTable<Key, Entry, KeyOf, Hash, Equal>::iterator
+HashTable<Key, Entry, KeyOf, Hash, Equal>::end()
+{
+    return m_entries.end();
+}
+
+/**
+ * @return Iterator past the last entry
+ */
+template<typename Key, typename Entry, typename KeyOf, typename Hash, typename Equal>
+typename HashTable<Key, Entry, KeyOf, Hash, Equal>::const_iterator
+HashTable<Key, Entry, KeyOf, Hash, Equal>::end() const
+{
+    return m_entries.end();
+}
+
+/**
+ * @param key The key to look for
+ * @return The entry with key or end() if not found
+ */
+template<typename Key, typename Entry, typename KeyOf, typename Hash, typename Equal>
+typename HashTable<Key, Entry, KeyOf, Hash, Equal>::iterator
+HashTable<Key, Entry, KeyOf, Hash, Equal>::find(const Key &key)
+{
+    if (m_entries.empty())
+        return end();
+    const Slot &slot = m_slots[findSlot(key, m_hash(key))];
+    return slot.m_index ? m_entries.begin() + (slot.m_index - 1) : end();
+}
+
+/**
+ * @param key The key to look for
+ * @return The entry with key or end() if not found
+ */
+template<typename Key, typename Entry, typename KeyOf, typename Hash, typename Equal>
+typename HashTable<Key, Entry, KeyOf, Hash, Equal>::const_iterator
+HashTable<Key, Entry, KeyOf, Hash, Equal>::find(const Key &key) const
+{
+    if (m_entries.empty())
+        return end();
+    const Slot &slot = m_slots[findSlot(key, m_hash(key))];
+    return slot.m_index ? m_entries.begin() + (slot.m_index - 1) : end();
+}
+
+/**
+ * @param key The key to look for
+ * @return 1 if found, otherwise 0
+ */
+template<typename Key, typename Entry, typename KeyOf, typename Hash, typename Equal>
+size_t HashTable<Key, Entry, KeyOf, Hash, Equal>::count(const Key &key) const
+{
+    return find(key) != end() ? 1 : 0;
+}
+
+/**
+ * Adds entry unless an entry with the same key is already present.
+ *
+ * @param entry What to add
+ * @return The entry with the key and true if it was added
+ */
+template<typename Key, typename Entry, typename KeyOf, typename Hash, typename Equal>
+std::pair<typename HashTable<Key, Entry, KeyOf, Hash, Equal>::iterator, bool>
+HashTable<Key, Entry, KeyOf, Hash, Equal>::insertEntry(const Entry &entry)
+{
+    if ((m_entries.size() + 1) * 4 > m_slots.size() * 3)
+        rehash(m_slots.empty() ? 8 : m_slots.size() * 2);
+
+    size_t  hash = m_hash(m_keyOf(entry));
+    size_t  pos = findSlot(m_keyOf(entry), hash);
+    if (m_slots[pos].m_index)
+        return std::make_pair(m_entries.begin() + (m_slots[pos].m_index - 1), false);
+
+    m_entries.push_back(entry);
+    m_hashes.push_back(hash);
+    m_slots[pos].m_index = static_cast<unsigned int>(m_entries.size());
+    m_slots[pos].m_tag = static_cast<unsigned int>(hash);
+    return std::make_pair(m_entries.end() - 1, true);
+}
+
+/**
+ * Removes the entry with key.  The last entry is moved
+ * to where the removed entry was.
+ *
+ * @param key The key of the entry to remove
+ * @return 1 if it was removed, 0 if not found
+ */
+template<typename Key, typename Entry, typename KeyOf, typename Hash, typename Equal>
+size_t HashTable<Key, Entry, KeyOf, Hash, Equal>::erase(const Key &key)
+{
+    if (m_entries.empty())
+        return 0;
+    size_t  pos = findSlot(key, m_hash(key));
+    if (!m_slots[pos].m_index)
+        return 0;
+    size_t  index = m_slots[pos].m_index - 1;
+
+    // Shift back any following slots that would no longer be found
+    const size_t mask = m_slots.size() - 1;
+    size_t  hole = pos;
+    for (size_t next = (hole + 1) & mask; m_slots[next].m_index; next = (next + 1) & mask)
+    {
+        size_t  home = m_hashes[m_slots[next].m_index - 1] & mask;
+        // Can move if home is not cyclically within (hole, next]
+        if (((next - home) & mask) >= ((next - hole) & mask))
+        {
+            m_slots[hole] = m_slots[next];
+            hole = next;
+        }
+    }
+    m_slots[hole].m_index = 0;
+
+    // Move the last entry into the hole in m_entries
+    size_t  last = m_entries.size() - 1;
+    if (index != last)
+    {
+        m_slots[slotOf(last)].m_index = static_cast<unsigned int>(index + 1);
+        m_entries[index] = std::move(m_entries[last]);
+        m_hashes[index] = m_hashes[last];
+    }
+    m_entries.pop_back();
+    m_hashes.pop_back();
+    return 1;
+}
+
+/**
+ * @param key The key to look for
+ * @param hash The hash of key
+ * @return Index in m_slots of key or the empty slot where it belongs
+ */
+template<typename Key, typename Entry, typename KeyOf, typename Hash, typename Equal>
+size_t HashTable<Key, Entry, KeyOf, Hash, Equal>::findSlot(const Key &key, size_t hash) const
+{
+    const size_t        mask = m_slots.size() - 1;
+    const unsigned int  tag = static_cast<unsigned int>(hash);
+    for (size_t pos = hash & mask; ; pos = (pos + 1) & mask)
+    {
+        const Slot &slot = m_slots[pos];
+        if (!slot.m_index)
+            return pos;
+        if (slot.m_tag == tag && m_equal(m_keyOf(m_entries[slot.m_index - 1]), key))
+            return pos;
+    }
+}
+
+/**
+ * @param index The index in m_entries
+ * @return Index in m_slots that refers to it
+ */
+template<typename Key, typename Entry, typename KeyOf, typename Hash, typename Equal>
+size_t HashTable<Key, Entry, KeyOf, Hash, Equal>::slotOf(size_t index) const
+{
+    const size_t    mask = m_slots.size() - 1;
+    size_t          pos = m_hashes[index] & mask;
+    while (m_slots[pos].m_index != index + 1)
+        pos = (pos + 1) & mask;
+    return pos;
+}
+
+/**
+ * Rebuilds m_slots from the saved hashes; the keys
+ * are not hashed again.
+ *
+ * @param capacity New number of slots; a power of two
+ */
+template<typename Key, typename Entry, typename KeyOf, typename Hash, typename Equal>
+void HashTable<Key, Entry, KeyOf, Hash, Equal>::rehash(size_t capacity)
+{
+    Slot    empty = { 0, 0 };
+    m_slots.assign(capacity, empty);
+    const size_t mask = capacity - 1;
+    for (size_t index = 0; index < m_hashes.size(); ++index)
+    {
+        size_t  pos = m_hashes[index] & mask;
+        while (m_slots[pos].m_index)
+            pos = (pos + 1) & mask;
+        m_slots[pos].m_index = static_cast<unsigned int>(index + 1);
+        m_slots[pos].m_tag = static_cast<unsigned int>(m_hashes[index]);
+    }
+}
+}
+#endif /* _PATH_HASHTABLE_H_ */
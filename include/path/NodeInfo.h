@@ -5,12 +5,18 @@
 #define _PATH_NODEINFO_H_
 
 #include <sys/types.h>  // Needed for off_t; workaround?
+#include <stdint.h>
+#include <time.h>
 
 namespace path
 {
 /**
  * @class NodeInfo path/NodeInfo.h
  * Provides basic information about a Node: size, modified time, owner, etc.
+ *
+ * SysBase::stat() only fills in the fields that were asked for
+ * (and that the file system could provide); use has() to check
+ * which are valid.
  */
 class NodeInfo
 {
@@ -24,11 +30,46 @@ public:
         FILE,       ///< This is a regular file
         DEVICE,     ///< This is a device
         OTHER,      ///< Not one of the above
+        UNKNOWN,    ///< Not known without calling stat()
+    };
+    /**
+     * Bits for selecting which fields SysBase::stat() fills in.
+     * These have the same values as the STATX_* bits of statx(2).
+     */
+    enum Field {
+        TYPE    = 0x0001,   ///< type()
+        MODE    = 0x0002,   ///< mode()
+        NLINK   = 0x0004,   ///< nlink()
+        UID     = 0x0008,   ///< uid()
+        GID     = 0x0010,   ///< gid()
+        ATIME   = 0x0020,   ///< atime()
+        MTIME   = 0x0040,   ///< mtime()
+        CTIME   = 0x0080,   ///< ctime()
+        INODE   = 0x0100,   ///< inode()
+        SIZE    = 0x0200,   ///< size()
+        BLOCKS  = 0x0400,   ///< blocks()
+        BTIME   = 0x0800,   ///< btime()
+        DEV     = 0x1000,   ///< dev()
+        BASIC   = TYPE | SIZE,  ///< What the original stat() returned
+        ALL     = 0x1fff        ///< Everything
     };
     /// Default constructor
     NodeInfo();
+    /// Copy constructor
+    NodeInfo(const NodeInfo &copy) = default;
+    /// Move constructor
+    NodeInfo(NodeInfo &&copy) = default;
     /// Destructor
     virtual ~NodeInfo();
+    /// Assignment operator
+    NodeInfo &operator=(const NodeInfo &op2) = default;
+    /// Move assignment operator
+    NodeInfo &operator=(NodeInfo &&op2) = default;
+
+    /// Return the Field bits that are valid
+    unsigned    fields() const;
+    /// Check if all of the Field bits are valid
+    bool        has(unsigned fields) const;
 
     /// Set the size in bytes
     NodeInfo &  setSize(off_t size);
@@ -42,9 +83,65 @@ public:
     bool        isFile() const;
     /// Check if this is a directory (DIRECTORY)
     bool        isDir() const;
+    /// Set the permission bits
+    NodeInfo &  setMode(mode_t mode);
+    /// Return the permission bits (without the type)
+    mode_t      mode() const;
+    /// Set the number of hard links
+    NodeInfo &  setNlink(uint64_t nlink);
+    /// Return the number of hard links
+    uint64_t    nlink() const;
+    /// Set the owner
+    NodeInfo &  setUid(uid_t uid);
+    /// Return the owner
+    uid_t       uid() const;
+    /// Set the group
+    NodeInfo &  setGid(gid_t gid);
+    /// Return the group
+    gid_t       gid() const;
+    /// Set the last access time
+    NodeInfo &  setAtime(const struct timespec &time);
+    /// Return the last access time
+    const struct timespec &atime() const;
+    /// Set the last modified time
+    NodeInfo &  setMtime(const struct timespec &time);
+    /// Return the last modified time
+    const struct timespec &mtime() const;
+    /// Set the last status change time
+    NodeInfo &  setCtime(const struct timespec &time);
+    /// Return the last status change time
+    const struct timespec &ctime() const;
+    /// Set the creation time
+    NodeInfo &  setBtime(const struct timespec &time);
+    /// Return the creation time
+    const struct timespec &btime() const;
+    /// Set the inode number
+    NodeInfo &  setInode(uint64_t inode);
+    /// Return the inode number
+    uint64_t    inode() const;
+    /// Set the device containing the file
+    NodeInfo &  setDev(uint64_t dev);
+    /// Return the device containing the file
+    uint64_t    dev() const;
+    /// Set the number of 512 byte blocks allocated
+    NodeInfo &  setBlocks(uint64_t blocks);
+    /// Return the number of 512 byte blocks allocated
+    uint64_t    blocks() const;
 private:
+    unsigned    m_fields;       ///< Which Field bits are valid
     off_t       m_size;         ///< Size in bytes
     Type        m_type;         ///< What type of file
+    mode_t      m_mode;         ///< Permission bits
+    uid_t       m_uid;          ///< Owner
+    gid_t       m_gid;          ///< Group
+    uint64_t    m_nlink;        ///< Number of hard links
+    uint64_t    m_inode;        ///< Inode number
+    uint64_t    m_dev;          ///< Device containing the file
+    uint64_t    m_blocks;       ///< 512 byte blocks allocated
+    struct timespec m_atime;    ///< Last access
+    struct timespec m_mtime;    ///< Last modified
+    struct timespec m_ctime;    ///< Last status change
+    struct timespec m_btime;    ///< Created
 
 };
 }
@@ -0,0 +1,125 @@
+/**
+ * @file ParallelWalker.h
+ */
+#ifndef _PATH_PARALLELWALKER_H_
+#define _PATH_PARALLELWALKER_H_
+
+#include <path/Path.h>
+#include <path/NodeInfo.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace path
+{
+class WalkQueue;
+
+/**
+ * @class ParallelWalker path/ParallelWalker.h
+ *
+ * Recursively lists a directory tree using several threads.
+ *
+ * Reading a directory mostly waits on the disk or the network,
+ * so many can be read at once.  Each thread keeps its own deque of
+ * directories still to be read: it takes the most recently found
+ * one from the back and, when it runs out, steals the oldest from
+ * the front of another thread's deque.  That keeps every thread
+ * busy without a single shared list to fight over.
+ *
+ * Every entry below the top directory (but not the top itself) is
+ * passed either to a callback or to a WalkQueue.  The order is
+ * not defined and the callback is called from all of the threads
+ * at once, so it must be thread safe:
+ *
+ * @code
+ * std::atomic<size_t>  bytes(0);
+ * ParallelWalker       walker(16);
+ * walker.walk(Path("/data"), [&](const Path &p, NodeInfo::Type type) {
+ *     if (type == NodeInfo::FILE)
+ *         bytes += p.size();
+ * });
+ * @endcode
+ *
+ * Symbolic links are reported but not followed unless
+ * setFollowLinks() is used.  Directories that can't be read are
+ * skipped.  If the callback throws, the walk stops and wait()
+ * rethrows the exception.
+ */
+class ParallelWalker
+{
+public:
+    /// Called for each entry found
+    typedef std::function<void(const Path &path, NodeInfo::Type type)> Callback;
+
+    /// Use threads threads or one per CPU if 0
+    explicit ParallelWalker(unsigned threads = 0);
+    /// Waits for any walk still running
+    ~ParallelWalker();
+
+    /// Return the number of threads used
+    unsigned threads() const;
+    /// Descend into symbolic links to directories
+    ParallelWalker &setFollowLinks(bool follow = true);
+
+    /// Call callback for everything below top and wait until done
+    void walk(const Path &top, const Callback &callback);
+    /// Start calling callback for everything below top
+    void start(const Path &top, const Callback &callback);
+    /// Start pushing everything below top onto queue
+    void start(const Path &top, WalkQueue &queue);
+    /// Wait for the walk started by start() to finish
+    void wait();
+    /// Ask a running walk to finish early
+    void stop();
+
+private:
+    /// Not copyable
+    ParallelWalker(const ParallelWalker &copy);
+    /// Not copyable
+    ParallelWalker &operator=(const ParallelWalker &op2);
+
+    /// The directories one thread still has to read
+    struct Worker
+    {
+        std::mutex          m_mutex;    ///< Protects m_dirs
+        std::deque<Path>    m_dirs;     ///< Owner uses the back, thieves the front
+        std::thread         m_thread;   ///< Runs run()
+    };
+
+    /// Start the threads
+    void launch(const Path &top, const Callback &callback);
+    /// Body of each thread
+    void run(unsigned index);
+    /// Read one directory
+    void readDir(unsigned index, const Path &dir);
+    /// Add dir to the deque of worker index
+    void push(unsigned index, const Path &dir);
+    /// Take a directory from worker index or steal one
+    bool take(unsigned index, Path &dir);
+    /// Finished with one directory
+    void finished();
+
+    unsigned            m_threads;      ///< How many threads to use
+    bool                m_follow;       ///< Follow symbolic links
+    Callback            m_callback;     ///< Where entries go
+    WalkQueue *         m_queue;        ///< Closed when the walk ends
+    std::vector<std::unique_ptr<Worker> > m_workers;    ///< One per thread
+
+    std::atomic<size_t> m_pending;      ///< Directories queued or being read
+    std::atomic<size_t> m_queued;       ///< Directories in some deque
+    std::atomic<bool>   m_stop;         ///< Set by stop() or an exception
+    std::atomic<unsigned> m_sleeping;   ///< Threads waiting in m_idle
+    std::mutex          m_idleMutex;    ///< For m_idle and m_error
+    std::condition_variable m_idle;     ///< Wakes threads when work is added
+    std::exception_ptr  m_error;        ///< First exception from the callback
+};
+}
+#endif /* _PATH_PARALLELWALKER_H_ */
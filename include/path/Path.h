@@ -9,15 +9,17 @@
 #include <path/RulesBase.h>
 #include <path/Strings.h>
 #include <path/Refcount.h>
+#include <path/NodeInfo.h>
 
 #include <string>
+#include <string_view>
 #include <iosfwd>
 
 namespace path {
 // Forward declarations
-class NodeInfo;
 class PathIter;
 class PathExtra;
+class PathTable;
 class Path;
 
 /// A list of Path
@@ -81,6 +83,20 @@ typedef std::vector<Path> Paths;
  *
  * Result in two identical paths.
  *
+ * A Path can also be created directly from a string using the
+ * default rules.  The string is kept as is and is what str() returns;
+ * it is only converted to a Canonical when something needs the
+ * individual components (e.g. dirname() or comparing two Paths).
+ * Paths that are only printed or passed to the operating system
+ * never create a Canonical.
+ *
+ * Normally each Path has it's own copy of the Canonical.  A Path
+ * returned by makeShared() instead creates children with add() that
+ * refer to the original Path plus the one new component.  This makes
+ * add(), dirname() and basename() constant time and is useful when
+ * creating many paths within the same directory hierarchy.  The
+ * Canonical and strings are only built when needed.
+ *
  * To list the contents of a directory, you can use the
  * iterator returned by begin(), glob(), and end() so you
  * can use Standard Template Library algorithms.  This
@@ -114,8 +130,17 @@ typedef std::vector<Path> Paths;
  *   
  *
  * 
+ * When many Paths need to be compared, PathTable can be used to
+ * keep a single copy of each one so comparisons are a single
+ * integer comparison.
+ *
+ * hash() is calculated once per Path and shared by all copies.
+ * It is used by std::hash<Path>, PathSet and PathMap.  operator<()
+ * orders by the hash first so it is also fast, but the
+ * order is not alphabetical.
+ *
  * @sa
- * Canonical, RulesBase, RulesUnix, Wn32Rules, RulesUri, Win32Path,
+ * PathTable, Canonical, RulesBase, RulesUnix, Wn32Rules, RulesUri, Win32Path,
  * UnixPath.
  */
 class Path
@@ -127,14 +152,22 @@ public:
     Path(const std::string &path);
     /// Use a Canonical path and RulesBase
     Path(const Canonical &canon, const RulesBase *rules = 0);
+    /// Use a Canonical path and RulesBase; canon is moved
+    Path(Canonical &&canon, const RulesBase *rules = 0);
     /// Construct from a NUL terminated string
     Path(const char *path);
+    /// Construct from a string_view
+    Path(std::string_view path);
     /// Copy constructor
     Path(const Path &copy);
+    /// Move constructor
+    Path(Path &&copy) noexcept;
     /// Destructor
     virtual ~Path();
     /// Assignment operator
     Path & operator=(const Path &op2);
+    /// Move assignment operator
+    Path & operator=(Path &&op2) noexcept;
 
     /// Return original path
     const std::string & str() const;
@@ -163,6 +196,10 @@ public:
     bool abs() const;
     /// Return a new path by converting this one to an absolute path
     Path makeAbs() const;
+    /// Return a new path whose children share it instead of copying it
+    Path makeShared() const;
+    /// Return if children share this path
+    bool shared() const;
 
     /// Return the drive letter (may be empty)
     const std::string &drive() const;
@@ -179,8 +216,12 @@ public:
     Path add(const Strings &strings) const;
     /// Concatenate a single string
     Path add(const std::string &p) const;
+    /// Concatenate a single string, moving it
+    Path add(std::string &&p) const;
     /// Concatenate a NUL terminated string
     Path add(const char *p) const;
+    /// Concatenate a single string without an extra copy
+    Path add(std::string_view p) const;
     /// Return each directory component as a Path.
     Paths split() const;
 
@@ -188,7 +229,7 @@ public:
     const Canonical &canon() const;
 
     /// Append a string to last element.
-    Path operator+(const std::string &append) const;
+    Path operator+(std::string_view append) const;
 
     /// Return the rules (may be NULL)
     const RulesBase *pathRules() const;
@@ -211,13 +252,15 @@ public:
     iterator end();
     /// And return the end of the list, const version
     const_iterator end() const;
-    /// Shorthand to only match a specific file in this directory
+    /// Iterate through what matches a shell pattern, which may have several components
     iterator glob(const std::string &pattern);
-    /// Shorthand to only match a specific file, const version
+    /// Iterate through what matches a shell pattern, const version
     const_iterator glob(const std::string &pattern) const;
 
     /// Return meta info about the underlying file.
     const NodeInfo &info() const;
+    /// Return meta info with at least these NodeInfo::Field bits valid
+    const NodeInfo &info(unsigned fields) const;
     /// Return the size in bytes of this file
     off_t size() const;
     /// Check if this Node exists
@@ -231,7 +274,30 @@ public:
     /// Create all directories and the file in Path
     static void mkfile(const Path &path, int dirmode = 0777, int filemode = 0666);
 
+    /// Return a hash of the Canonical; it is only calculated once
+    size_t hash() const;
+
+    /// Return true if both were interned in the same PathTable
+    bool sameTable(const Path &path) const;
+    /// Return true if this and path are the same interned Path
+    bool sameInterned(const Path &path) const;
+
 private:
+    friend class PathTable;
+    friend class PathIter;
+    friend class PathGlob;
+    /// Share the data of another Path
+    Path(const Refcount<PathExtra> &meta);
+    /// Create a path with the same rules and sharing
+    Path withCanon(const Canonical &canon) const;
+    /// Create a path with the same rules and sharing, moving canon
+    Path withCanon(Canonical &&canon) const;
+    /// Create a path that refers to this one as its parent
+    Path child(std::string name) const;
+    /// Return the data for this Path; never NULL
+    PathExtra *meta() const;
+    /// Keep what reading a directory found out about this Path
+    void listed(NodeInfo::Type type, uint64_t inode);
     /// Use these rules if none are set.
     static RulesBase *      s_defaultRulesBase;
     mutable Refcount<PathExtra> m_meta;
@@ -241,22 +307,41 @@ private:
 Paths strings2Paths(const Strings &strings, const RulesBase *rules = 0);
 // Shortcuts for handling different paths as strings
 /// Convert a unix style path ("/a/b/c") to Canonical
-path::Canonical UnixPath(const std::string &path);
+path::Canonical UnixPath(std::string_view path);
 /// Convert a Win32 style path ("C:\temp") to Canonical
-path::Canonical Win32Path(const std::string &path);
+path::Canonical Win32Path(std::string_view path);
 /// Convert a URL style path ("http://www.peteware.com/a") to Canonical
-path::Canonical URLPath(const std::string &path);
-}
+path::Canonical URLPath(std::string_view path);
 /// Check if Cannonical names are the same
 bool operator==(const path::Path &op1, const path::Path &op2);
 /// Check if Cannonical names are different.
 bool operator!=(const path::Path &op1, const path::Path &op2);
+/// Fast ordering suitable for sorting and std::map (not alphabetical)
+bool operator<(const path::Path &op1, const path::Path &op2);
 /// Print out the path
 std::ostream &operator<<(std::ostream &out, const path::Path&path);
 /// Add a new directory
 path::Path operator/(const path::Path &path, const char *dir);
 /// Add a new directory
 path::Path operator/(const path::Path &path, const std::string &dir);
+/// Add a new directory, moving dir
+path::Path operator/(const path::Path &path, std::string &&dir);
+/// Add a new directory
+path::Path operator/(const path::Path &path, std::string_view dir);
 /// Concatenate two paths
 path::Path operator/(const path::Path &path, const path::Path &op2);
+}
+
+namespace std {
+/// Allows Path to be used in std::unordered_map and std::unordered_set
+template<>
+struct hash<path::Path>
+{
+    /// Return path.hash()
+    size_t operator()(const path::Path &path) const
+    {
+        return path.hash();
+    }
+};
+}
 #endif // !defined(_PATH_PATH_H_)
@@ -17,7 +17,11 @@ class PathBadException : public PathException
 public:
     PathBadException();
     PathBadException(const std::string &path, int err);
+    PathBadException(const PathBadException &copy) = default;
+    PathBadException(PathBadException &&copy) = default;
     virtual ~PathBadException() throw();
+    PathBadException &operator=(const PathBadException &op2) = default;
+    PathBadException &operator=(PathBadException &&op2) = default;
 
 };
 }
@@ -27,7 +27,11 @@ public:
     PathException();
     PathException(const std::string &filename, int the_errno);
     PathException(const std::string &filename);
+    PathException(const PathException &copy) = default;
+    PathException(PathException &&copy) = default;
     virtual ~PathException() throw();
+    PathException &operator=(const PathException &op2) = default;
+    PathException &operator=(PathException &&op2) = default;
     int             err() const;
     std::string filename() const;
 private:
@@ -4,6 +4,9 @@
 #ifndef _PATH_PATHEXTRA_H_
 #define _PATH_PATHEXTRA_H_
 
+#include <path/Refcount.h>
+#include <path/NodeInfo.h>
+#include <atomic>
 #include <string>
 
 namespace path {
@@ -12,15 +15,19 @@ namespace path {
 class Path;
 class RulesBase;
 class Canonical;
-class NodeInfo;
+class PathTable;
 
 /**
  * @class PathExtra path/PathExtra.h
  *
  * Multiple copies of a Path object share the
  * same underlying data.
+ *
+ * The reference count is kept in the object (see RefcountBase)
+ * and the cached values are filled in atomically so copies of
+ * the same Path can be used from different threads.
  */
-class PathExtra
+class PathExtra : public RefcountBase
 {
 public:
     //friend class Path;
@@ -35,14 +42,65 @@ public:
      *
      * This is the uninterpreted string and is the value returned by str().
      */
-    std::string *           m_path;
+    std::atomic<std::string *>  m_path;
     /// These are the rules we use for this path; may be NULL
     const RulesBase *               m_rules;
     /// The path in canonical form; may be NULL
-    Canonical *m_canon;
+    std::atomic<Canonical *>    m_canon;
     /// Cached value path converted by path();
-    std::string *   m_pathStr;
-    NodeInfo * m_cache;
+    std::atomic<std::string *>  m_pathStr;
+    /// Cached value of info(); may be NULL
+    std::atomic<NodeInfo *>     m_cache;
+    /// Made from m_type and m_inode when first asked for; may be NULL
+    std::atomic<NodeInfo *>     m_listed;
+    /// First result of Path::info(unsigned) that needed System.stat(); may be NULL
+    std::atomic<NodeInfo *>     m_partial;
+    /// Type found reading the directory holding it; NodeInfo::UNKNOWN if not read
+    NodeInfo::Type              m_type;
+    /// Inode found at the same time; 0 if not known
+    uint64_t                    m_inode;
+    /// Cached value of Path::hash(); 0 until calculated
+    std::atomic<size_t>         m_hash;
+
+    /// Set slot to value unless already set; return the one that was kept
+    template<typename Type>
+    static Type *publish(std::atomic<Type *> &slot, Type *value);
+    /**
+     * When set, this path is m_parent plus m_name and m_canon
+     * is built from them when first needed.
+     */
+    Refcount<PathExtra>     m_parent;
+    /// The last component when m_parent is set
+    std::string             m_name;
+    /// add() creates children that share this path as m_parent
+    bool                    m_shared;
+    /**
+     * The PathTable this was interned in; may be NULL.  Atomic as
+     * PathTable::clear() resets it while other threads may be
+     * comparing Paths; relaxed is enough as it only picks a shortcut.
+     */
+    std::atomic<const PathTable *>  m_table;
+    /// Id within m_table
+    std::atomic<unsigned int>       m_id;
 };
+
+/**
+ * Used to lazily fill in one of the cached values.  If another
+ * thread got there first, value is deleted and the other thread's
+ * value is returned.
+ *
+ * @param slot Where to store value
+ * @param value Newly allocated value
+ * @return The value stored in slot
+ */
+template<typename Type>
+Type *PathExtra::publish(std::atomic<Type *> &slot, Type *value)
+{
+    Type *  expected = 0;
+    if (slot.compare_exchange_strong(expected, value, std::memory_order_acq_rel))
+        return value;
+    delete value;
+    return expected;
+}
 }
 #endif /* _PATH_PATHEXTRA_H_ */
@@ -0,0 +1,87 @@
+/**
+ * @file PathGlob.h
+ */
+#ifndef _PATH_PATHGLOB_H_
+#define _PATH_PATHGLOB_H_
+
+#include <path/Path.h>
+#include <path/Glob.h>
+#include <path/DirEntries.h>
+
+#include <string>
+#include <vector>
+
+namespace path {
+/**
+ * @class PathGlob path/PathGlob.h
+ * Finds everything below a directory that matches a shell
+ * pattern of several components, like "2024/[01]?/logs/[a-z]*.gz".
+ * This is what Path::glob() uses.
+ *
+ * The pattern is split at each '/' and each component is
+ * handled on its own:
+ * - A component without any of "*?[{\\" is just a name.  Nothing
+ *   is read for it; if it is the last one, one exists() checks it.
+ * - Any other component is a Glob compared with each name in the
+ *   directory.  Like the shell, a '.' at the start of a name must be
+ *   matched by a '.' in the pattern.
+ * - "**" matches any number of directories, including none.  It
+ *   doesn't go into hidden directories or follow symbolic links.
+ *   As the last component it matches everything below the directory.
+ *
+ * So only the directories the pattern can still match are read.
+ * For "2024/[01]?/logs" only "2024" is listed; nothing in "2024/12"
+ * is read until "2024/12/logs".  Braces can't contain a '/'.
+ *
+ * @code
+ * Paths    found;
+ * PathGlob(Path("/data"), "2024/[01]?/logs/[a-z]*.gz").find(found);
+ * @endcode
+ */
+class PathGlob
+{
+public:
+    /// Prepare to find what matches pattern in dir
+    PathGlob(const Path &dir, const std::string &pattern);
+    /// Destructor
+    ~PathGlob();
+    /// Add every match to found, each directory in BYTEWISE order
+    void find(Paths &found) const;
+
+private:
+    /// What a component of the pattern is
+    enum Kind
+    {
+        NAME,                   ///< Just a name
+        PATTERN,                ///< Compared with each name in the directory
+        ANY                     ///< "**"
+    };
+    /// One component of the pattern
+    struct Component
+    {
+        Kind        m_kind;     ///< What it is
+        std::string m_name;     ///< The component as given
+        Glob        m_glob;     ///< Compiled unless m_kind is NAME
+        bool        m_hidden;   ///< Matches names starting with '.'
+
+        /// Set up component name
+        Component(const std::string &name);
+    };
+
+    /// Find what matches components index onwards in dir
+    void walk(const Path &dir, size_t index, Paths &found) const;
+    /// Find what matches components index onwards among entries of dir
+    void entries(const Path &dir, const DirEntries &entries,
+                 const std::vector<size_t> &order, size_t index, Paths &found) const;
+    /// Read dir; false if it isn't a directory that can be read
+    static bool read(const Path &dir, DirEntries &entries, std::vector<size_t> &order);
+    /// Return dir with entry added, keeping what readdir() found out
+    static Path child(const Path &dir, const DirEntry &entry);
+
+    /// Where to start
+    Path                    m_dir;
+    /// The pattern split at each '/'
+    std::vector<Component>  m_components;
+};
+}
+#endif /* _PATH_PATHGLOB_H_ */
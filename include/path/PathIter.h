@@ -4,13 +4,16 @@
 #if !defined(_PATH_PATHITER_H_)
 #define _PATH_PATHITER_H_
 
+#include <path/Path.h>
+#include <path/DirEntries.h>
+#include <path/Refcount.h>
+
+#include <functional>
 #include <iterator>
 #include <string>
 #include <vector>
 
 namespace path {
-// Forward declarations
-class Path;
 /**
  * @class PathIter path/PathIter.h
  * Used to iterate over the Nodes within a Directory.
@@ -20,25 +23,64 @@ class Path;
  * -# Just list the contents of the directory.  This is the default
  *
  * -# List the contents of the directory and all subdirectories (recursively).
- *    This can be done either:
- *    - Depth first: All subdirectories are visited first.
- *    - Breadth first: All Files are visited then subdirectories
- *    - In order: Directories and Files are traversed in the order they
- *      are listed.  This is the most efficient.
+ *    This can be done either (see setRecursive()):
+ *    - Depth first: Everything in a subdirectory is visited right
+ *      after the subdirectory itself.  Each directory is sorted by name.
+ *    - Breadth first: Everything in a directory is visited then its
+ *      subdirectories, one level at a time.  Each directory is sorted
+ *      by name.
+ *    - In order: Like depth first but directories and files are traversed
+ *      in the order they are listed.  This is the most efficient.
+ *
+ * Each directory is sorted by name unless setSort() says otherwise.
  *
  * Additionally, you can use either shell style expansion (glob),
  * regular expressions, or a predicate function to determine if a File
- * or Directory should be examined.
+ * or Directory should be examined.  A glob or regular expression is
+ * compared with each name as it is read, so an entry that doesn't
+ * match costs neither a Path nor a stat().  Recursively, directories
+ * that don't match are still read but not visited.
+ *
+ * Depth first and in order keep only the directories between the
+ * starting Node and the current entry, so memory use depends on how
+ * deep and wide the tree is rather than how many entries it has.
+ * Breadth first keeps the current directory and the Path of every
+ * subdirectory it has found but not yet read.
+ *
+ * Subdirectories can be skipped with prune(), setDirFilter() or
+ * setMaxDepth().  These are checked before a subdirectory is opened
+ * so nothing below it is ever read.
  *
+ * Copying a PathIter is cheap: copies share the same state until
+ * one of them is incremented or changed, which then gets its own.
  */
-class PathIter :  public std::iterator<std::forward_iterator_tag, Path>
+class PathIter
 {
 
 public:
+    typedef std::forward_iterator_tag   iterator_category;  ///< Can only go forward
+    typedef Path                        value_type;         ///< What it visits
+    typedef std::ptrdiff_t              difference_type;    ///< For std::distance()
+    typedef Path                       *pointer;            ///< operator->()
+    typedef Path                       &reference;          ///< operator*()
+
+    /// How setRecursive() visits subdirectories
+    enum TraversalOrder
+    {
+        DEPTH_FIRST,                ///< Subdirectory contents right after it, sorted
+        BREADTH_FIRST,              ///< One level at a time, sorted
+        IN_ORDER                    ///< Depth first in the order listed
+    };
+
+    /// Return true to descend into the directory
+    typedef std::function<bool(const Path &dir)> DirFilter;
+
     /// The end() iterator
     PathIter();
     /// Copy constructor
     PathIter(const PathIter &copy);
+    /// Move constructor
+    PathIter(PathIter &&copy) noexcept;
     /// Create from a Node.
     PathIter(const Path &node);
     /// Regular expression macher
@@ -47,6 +89,8 @@ public:
     ~PathIter();
     /// Assignment operator
     PathIter &operator=(const PathIter &op2);
+    /// Move assignment operator
+    PathIter &operator=(PathIter &&op2) noexcept;
     /// Dereferencing
     Path * operator->();
     /// Dereferencing
@@ -62,25 +106,30 @@ public:
     /// Add another element to the iter
     void addPath(const Path &path);
     /// Make this a recursive iterator
-    PathIter & setRecursive();
+    PathIter & setRecursive(TraversalOrder order = DEPTH_FIRST);
+    /// Read subdirectories relative to their open parent directory
+    PathIter & setRelative();
+    /// Choose how each directory is sorted
+    PathIter & setSort(DirEntries::SortOrder how);
+    /// Don't descend into the current entry
+    void prune();
+    /// Only descend into directories filter accepts
+    PathIter & setDirFilter(const DirFilter &filter);
+    /// Don't descend more than depth levels of subdirectories
+    PathIter & setMaxDepth(size_t depth);
     /// Check if matches against pattern
     bool match(const Path &path) const;
 
 private:
-    /// Returns the node this iterator is referencing
-    Path *      findNode(int index) const;
-    /// List all Node's in node and add to m_nodeList
-    void addNodes(const Path *node);
-    /// Return number of Node
-    int         size() const;
-    /// Actual Node being iterated over
-    const Path *m_parent;
-    /// List of subdirs
-    std::vector<Path *> m_nodeList;
-    /// Current index
-    int                     m_current;
-    /// Traverse subdirectories, too
-    bool        m_recursive;
+    /// Everything needed to carry on iterating; shared by copies
+    struct State;
+    /// Return true if this is the end() iterator
+    bool        atEnd() const;
+    /// Give this its own State before changing it
+    State &     unshare();
+
+    /// Shared until one of the copies is changed; null for end()
+    Refcount<State> m_state;
 };
 }
 #endif // !defined(_PATH_PATHITER_H_)
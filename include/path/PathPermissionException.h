@@ -18,8 +18,16 @@ public:
     PathPermissionException();
     /// Include path and errno
     PathPermissionException (const std::string &path, int err);
+    /// Copy constructor
+    PathPermissionException(const PathPermissionException &copy) = default;
+    /// Move constructor
+    PathPermissionException(PathPermissionException &&copy) = default;
     /// Destructor
     virtual ~PathPermissionException() throw();
+    /// Assignment operator
+    PathPermissionException &operator=(const PathPermissionException &op2) = default;
+    /// Move assignment operator
+    PathPermissionException &operator=(PathPermissionException &&op2) = default;
 
 };
 }
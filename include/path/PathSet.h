@@ -0,0 +1,18 @@
+/**
+ * @file PathSet.h
+ */
+#ifndef _PATH_PATHSET_H_
+#define _PATH_PATHSET_H_
+
+#include <path/Path.h>
+#include <path/HashTable.h>
+
+namespace path {
+/// A set of unique Paths using Path::hash()
+typedef HashSet<Path> PathSet;
+
+/// Map from a Path to a Value using Path::hash()
+template<typename Value>
+using PathMap = HashMap<Path, Value>;
+}
+#endif /* _PATH_PATHSET_H_ */
@@ -0,0 +1,77 @@
+/**
+ * @file PathTable.h
+ */
+#ifndef _PATH_PATHTABLE_H_
+#define _PATH_PATHTABLE_H_
+
+#include <path/Path.h>
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+namespace path
+{
+/**
+ * @class PathTable path/PathTable.h
+ *
+ * Keeps exactly one copy of each distinct Path.
+ *
+ * intern() returns the Path stored in the table that is equal to
+ * its argument, adding it if necessary.  Each entry is given an id
+ * that does not change for the life of the table.  All the Paths
+ * returned by intern() for equal values share the same underlying
+ * data, so comparing two Paths interned in the same table only
+ * compares the ids and id() can be used directly as a hash value.
+ *
+ * @code
+ * PathTable    table;
+ * Path p1 = table.intern(Path(UnixPath("/a/b")));
+ * Path p2 = table.intern(Path(UnixPath("/a/b")));
+ * // p1 == p2 without comparing any components
+ * // and table.id(p1) == table.id(p2)
+ * @endcode
+ *
+ * Paths returned by intern() remain valid after the table
+ * is destroyed but are then compared the regular way.  A
+ * PathTable is not safe to use from multiple threads without
+ * locking, but the Paths it returned can be compared on other
+ * threads even while it is cleared or destroyed.
+ */
+class PathTable
+{
+public:
+    /// Identifies a Path in the table
+    typedef unsigned int Id;
+
+    /// Default constructor
+    PathTable();
+    /// Destructor
+    ~PathTable();
+
+    /// Return the Path in the table equal to path; add it if needed
+    Path intern(const Path &path);
+    /// Return the id of path, adding it if needed
+    Id id(const Path &path);
+    /// Return true if path was returned by intern() on this table
+    bool contains(const Path &path) const;
+    /// Return the Path with the given id
+    const Path &operator[](Id id) const;
+    /// Return the number of distinct Paths
+    size_t size() const;
+    /// Remove all the Paths
+    void clear();
+
+private:
+    /// Not copyable
+    PathTable(const PathTable &copy);
+    /// Not copyable
+    PathTable &operator=(const PathTable &op2);
+
+    /// Each distinct Path indexed by its Id
+    Paths   m_paths;
+    /// Map from Path::hash() to the Id's with that hash
+    std::unordered_multimap<size_t, Id>     m_index;
+};
+}
+#endif /* _PATH_PATHTABLE_H_ */
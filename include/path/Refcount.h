@@ -7,8 +7,51 @@
  *  Copyright 2008 Pete Ware, Inc. All rights reserved.
  *
  */
+#ifndef _PATH_REFCOUNT_H_
+#define _PATH_REFCOUNT_H_
+
+#include <atomic>
+#include <type_traits>
+#include <utility>
 
 namespace path {
+/**
+ * @class RefcountBase path/Refcount.h
+ * Derive from this to keep the reference count inside the object.
+ *
+ * A Refcount to a type derived from RefcountBase uses this count
+ * instead of allocating a separate one.  It also means a Refcount
+ * can safely be created more than once from the same pointer.
+ */
+class RefcountBase
+{
+public:
+    /// Start with no references
+    RefcountBase() : m_refs(0) {}
+    /// Copies start with no references
+    RefcountBase(const RefcountBase &) : m_refs(0) {}
+    /// The count is not assigned
+    RefcountBase &operator=(const RefcountBase &) { return *this; }
+private:
+    template<typename Type> friend class Refcount;
+    /// Number of Refcount objects referring to this
+    mutable std::atomic<int>    m_refs;
+};
+
+/**
+ * @class Refcount path/Refcount.h
+ * A pointer that deletes the object when the last reference goes away.
+ *
+ * The count is updated atomically so copies can be passed between
+ * threads.  Incrementing uses a relaxed memory order as a new
+ * reference can only be made from an existing one; decrementing uses
+ * acquire/release so the object is only deleted after every other
+ * thread is finished with it.  Moving a Refcount doesn't change the
+ * count at all and a NULL Refcount doesn't allocate anything.
+ *
+ * If Type is derived from RefcountBase the count is kept in the
+ * object itself, otherwise it is allocated separately.
+ */
 template<typename Type> class Refcount
 {
 public:
@@ -18,20 +61,32 @@ public:
     Refcount(Type *ptr);
     /// Copy by incrementing reference count
     Refcount(const Refcount &ref);
+    /// Move without changing reference count
+    Refcount(Refcount &&ref) noexcept;
     /// Destructor.  Decrement reference count
     ~Refcount();
 
     /// Assignment operator increases referecence count
     Refcount &operator=(const Refcount &op2);
+    /// Move assignment leaves op2 NULL
+    Refcount &operator=(Refcount &&op2) noexcept;
     /// Dereference operator
     Type &operator*();
     /// Derference and access operator
     Type *operator->();
+    /// Return the underlying pointer (may be NULL)
+    Type *get() const;
     /// Return how many references
     int count() const;
+    /// Exchange with another Refcount
+    void swap(Refcount &op2) noexcept;
 private:
-    /// Counts the total number of references
-    int *   m_count;
+    /// True if the count is kept inside Type
+    static constexpr bool intrusive() { return std::is_base_of<RefcountBase, Type>::value; }
+    /// Return the count to use; NULL if m_data is NULL
+    std::atomic<int> *counter() const;
+    /// Counts the total number of references; NULL if intrusive or m_data is NULL
+    std::atomic<int> *  m_count;
     /// The underlying shared object
     Type *  m_data;
     /// Increase the number of references
@@ -45,18 +100,21 @@ private:
  */
 template<typename Type>
 Refcount<Type>::Refcount()
-    : m_count(new int),
+    : m_count(0),
       m_data(0)
 {
-    *m_count = 0;
 }
 
 template<typename Type>
 Refcount<Type>::Refcount(Type *ptr)
-    : m_count (new int),
+    : m_count(0),
       m_data(ptr)
 {
-    *m_count = 1;
+    if (!m_data)
+        return;
+    if constexpr (!intrusive())
+        m_count = new std::atomic<int>(0);
+    IncReference();
 }
 
 template<typename Type>
@@ -67,6 +125,15 @@ Refcount<Type>::Refcount(const Refcount &ref)
     IncReference();
 }
 
+template<typename Type>
+Refcount<Type>::Refcount(Refcount &&ref) noexcept
+    : m_count(ref.m_count),
+      m_data(ref.m_data)
+{
+    ref.m_count = 0;
+    ref.m_data = 0;
+}
+
 template<typename Type>
 Refcount<Type>::~Refcount()
 {
@@ -76,10 +143,16 @@ Refcount<Type>::~Refcount()
 template<typename Type>
 Refcount<Type> & Refcount<Type>::operator=(const Refcount &op2)
 {
-    DecReference();
-    m_count = op2.m_count;
-    m_data = op2.m_data;
-    IncReference();
+    Refcount    tmp(op2);
+    swap(tmp);
+    return *this;
+}
+
+template<typename Type>
+Refcount<Type> & Refcount<Type>::operator=(Refcount &&op2) noexcept
+{
+    Refcount    tmp(std::move(op2));
+    swap(tmp);
     return *this;
 }
 
@@ -95,32 +168,60 @@ inline Type * Refcount<Type>::operator->()
     return m_data;
 }
 
+template<typename Type>
+inline Type * Refcount<Type>::get() const
+{
+    return m_data;
+}
+
 template<typename Type>
 int Refcount<Type>::count() const
 {
-    if (m_count)
-        return *m_count;
+    std::atomic<int> *c = counter();
+    if (c)
+        return c->load(std::memory_order_relaxed);
     else
         return 0;
 }
+
+template<typename Type>
+void Refcount<Type>::swap(Refcount &op2) noexcept
+{
+    std::swap(m_count, op2.m_count);
+    std::swap(m_data, op2.m_data);
+}
+
+template<typename Type>
+inline std::atomic<int> * Refcount<Type>::counter() const
+{
+    if constexpr (intrusive())
+        return m_data ? &m_data->m_refs : 0;
+    else
+        return m_count;
+}
+
 template<typename Type>
 void Refcount<Type>::DecReference()
 {
-    --*m_count;
-    if (*m_count <= 0)
+    std::atomic<int> *c = counter();
+    if (!c)
+        return;
+    if (c->fetch_sub(1, std::memory_order_acq_rel) == 1)
     {
         delete m_data;
         delete m_count;
-        m_data = 0;
-        m_count = 0;
     }
+    m_data = 0;
+    m_count = 0;
 }
 
 template<typename Type>
 void Refcount<Type>::IncReference()
 {
-    if (m_count)
-        ++*m_count;
+    std::atomic<int> *c = counter();
+    if (c)
+        c->fetch_add(1, std::memory_order_relaxed);
 }
 
 }
+#endif /* _PATH_REFCOUNT_H_ */
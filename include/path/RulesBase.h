@@ -6,6 +6,7 @@
 
 #include <path/Strings.h>
 #include <string>
+#include <string_view>
 
 namespace path {
 // Forward declarations
@@ -32,9 +33,11 @@ public:
     /// Convert Canonical into a string
     virtual std::string str(const Canonical &canononical) const;
     /// Convert a raw path (aka a string) into Canonical
-    virtual Canonical canonical(const std::string &path) const = 0;
+    virtual Canonical canonical(std::string_view path) const = 0;
     /// Quote an element of path
     virtual bool quote(const std::string &subdir, std::string *dest) const = 0;
+    /// Return true if quote() would change any part of subdir
+    virtual bool needsQuote(std::string_view subdir) const;
     /// Unquote (dequote?) an element of path
     virtual bool unquote(const std::string &subdir, std::string *dest) const = 0;
 protected:
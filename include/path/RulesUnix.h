@@ -17,7 +17,7 @@ public:
     RulesUnix();
     virtual ~RulesUnix();
 
-    virtual Canonical   canonical(const std::string &path) const;
+    virtual Canonical   canonical(std::string_view path) const;
     virtual bool quote(const std::string &subdir, std::string *dest) const;
     virtual bool unquote(const std::string &subdir, std::string *dest) const;
 
@@ -19,7 +19,7 @@ public:
     RulesUri();
     virtual ~RulesUri();
 
-    virtual Canonical canonical(const std::string &path) const;
+    virtual Canonical canonical(std::string_view path) const;
     virtual bool quote(const std::string & subdirs, std::string *dest) const;
 
 };
@@ -21,7 +21,9 @@ public:
 
     static RulesWin32    rules;
 
-    virtual Canonical canonical(const std::string &path) const;
+    virtual Canonical canonical(std::string_view path) const;
+    /// Nothing is quoted so this is always false
+    virtual bool needsQuote(std::string_view subdir) const;
     virtual bool quote(const std::string & path, std::string *dest) const;
     virtual bool unquote(const std::string &subdir, std::string *dest) const;
 };
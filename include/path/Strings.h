@@ -6,7 +6,9 @@
 
 #include <vector>
 #include <string>
+#include <string_view>
 #include <map>
+#include <cstdint>
 
 namespace path {
 /// A vector of strings
@@ -16,6 +18,46 @@ typedef std::map<std::string, std::string> StringMap;
 /// Return a string with all $VAR replaced
 std::string expand(const std::string &str, const StringMap & vars, bool tilde);
 /// Split a string with a sperator character
-void split(const std::string &str, char sep, Strings &strings);
+void split(std::string_view str, char sep, Strings &strings);
+
+/**
+ * @class Splitter path/Strings.h
+ *
+ * Returns each component of a string seperated by a single
+ * character without copying anything.  The string is scanned
+ * for separators 64 bytes at a time using SSE2 or AVX2 (when
+ * compiled with them) so long components cost very little.
+ *
+ * @code
+ * Splitter         splitter(str, '/');
+ * std::string_view component;
+ * while (splitter.next(component))
+ * {...}
+ * @endcode
+ *
+ * Like split(), an empty string has no components and
+ * "a//b/" has the components "a", "", "b" and "".
+ */
+class Splitter
+{
+public:
+    /// Split str at each sep; str must outlive the Splitter
+    Splitter(std::string_view str, char sep);
+    /// Set component to the next component; false at the end
+    bool next(std::string_view &component);
+
+private:
+    /// Return offset of the next seperator or npos
+    size_t nextSeparator();
+    /// Return a bit set for each sep in the 64 bytes at offset
+    uint64_t block(size_t offset) const;
+
+    std::string_view    m_str;      ///< The string being split
+    char                m_sep;      ///< The seperator
+    size_t              m_start;    ///< Start of the next component
+    size_t              m_base;     ///< Offset of the block in m_mask
+    uint64_t            m_mask;     ///< Unreturned seperators in this block
+    bool                m_done;     ///< The last component was returned
+};
 }
 #endif /* _PATH_STRINGS_H_ */
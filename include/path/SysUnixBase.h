@@ -33,8 +33,26 @@ public:
     virtual void remove(const std::string &file) const;
     /// Return a vector with directory contents
     virtual Strings listdir(const std::string &dir) const;
+    /// Read the names, types and inodes in a directory
+    virtual bool readdir(const std::string &dir, DirEntries &entries) const;
+    /// Open a directory for the calls relative to a directory
+    virtual int opendir(const std::string &dir) const;
+    /// Open a subdirectory of an open directory
+    virtual int opendirat(int dirfd, const char *name) const;
+    /// Close a directory from opendir() or opendirat()
+    virtual void closedir(int dirfd) const;
+    /// Read the names, types and inodes in an open directory
+    virtual bool readdir(int dirfd, DirEntries &entries) const;
+    /// Return info about a file in an open directory
+    virtual NodeInfo * statat(int dirfd, const char *name,
+                              unsigned fields = NodeInfo::ALL,
+                              bool follow = true) const;
+    /// Remove a file or empty directory in an open directory
+    virtual void removeat(int dirfd, const char *name, bool dir = false) const;
     /// Return info about a file or directory
-    virtual NodeInfo * stat(const std::string & path) const;
+    virtual NodeInfo * stat(const std::string & path,
+                            unsigned fields = NodeInfo::ALL,
+                            bool follow = true) const;
     /// Return if the path exists.
     virtual bool exists(const std::string &path) const;
     /// Return the current working directory
@@ -33,7 +33,9 @@ public:
     /// Return a vector with directory contents
     virtual Strings listdir(const std::string &dir) const;
     /// Return info about a file or directory
-    virtual NodeInfo * stat(const std::string & path) const;
+    virtual NodeInfo * stat(const std::string & path,
+                            unsigned fields = NodeInfo::ALL,
+                            bool follow = true) const;
     /// Return if the path exists.
     virtual bool exists(const std::string &path) const;
     /// Return the current working directory
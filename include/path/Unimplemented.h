@@ -17,7 +17,11 @@ class Unimplemented : public Exception
 {
 public:
     Unimplemented(const std::string &operation);
+    Unimplemented(const Unimplemented &copy) = default;
+    Unimplemented(Unimplemented &&copy) = default;
     virtual ~Unimplemented() throw();
+    Unimplemented &operator=(const Unimplemented &op2) = default;
+    Unimplemented &operator=(Unimplemented &&op2) = default;
 private:
 };
 }
@@ -0,0 +1,81 @@
+/**
+ * @file WalkQueue.h
+ */
+#ifndef _PATH_WALKQUEUE_H_
+#define _PATH_WALKQUEUE_H_
+
+#include <path/Path.h>
+#include <path/NodeInfo.h>
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+namespace path
+{
+/**
+ * @class WalkQueue path/WalkQueue.h
+ *
+ * A bounded queue of Paths safe to use from any number of
+ * producer and consumer threads.  ParallelWalker::start() fills
+ * one while the caller empties it:
+ *
+ * @code
+ * ParallelWalker   walker(8);
+ * WalkQueue        queue(4096);
+ * walker.start(Path("/data"), queue);
+ * Path             p;
+ * while (queue.pop(p))
+ *     std::cout << p << std::endl;
+ * walker.wait();
+ * @endcode
+ *
+ * push() waits while the queue is full, so a slow consumer holds
+ * back the walk instead of letting it use unbounded memory.  Either
+ * side may close() the queue; after that push() fails and pop()
+ * returns what is left and then fails.
+ */
+class WalkQueue
+{
+public:
+    /// Create a queue holding at most capacity entries
+    explicit WalkQueue(size_t capacity = 1024);
+    /// Destructor
+    ~WalkQueue();
+
+    /// Add an entry, waiting while full; false if closed
+    bool push(const Path &path, NodeInfo::Type type = NodeInfo::UNKNOWN);
+    /// Remove an entry, waiting while empty; false if closed and empty
+    bool pop(Path &path, NodeInfo::Type *type = 0);
+    /// No more entries may be pushed
+    void close();
+    /// Return true if close() was called
+    bool closed() const;
+    /// Return the number of entries waiting
+    size_t size() const;
+    /// Return the most entries it will hold
+    size_t capacity() const;
+
+private:
+    /// Not copyable
+    WalkQueue(const WalkQueue &copy);
+    /// Not copyable
+    WalkQueue &operator=(const WalkQueue &op2);
+
+    /// One queued entry
+    struct Entry
+    {
+        Path            m_path;     ///< The entry
+        NodeInfo::Type  m_type;     ///< Its type if known
+    };
+    std::vector<Entry>      m_ring;     ///< Circular buffer of entries
+    size_t                  m_head;     ///< Index of the next entry to pop
+    size_t                  m_count;    ///< Number of entries in m_ring
+    bool                    m_closed;   ///< Set by close()
+    mutable std::mutex      m_mutex;    ///< Protects all of the above
+    std::condition_variable m_notEmpty; ///< Signaled by push() and close()
+    std::condition_variable m_notFull;  ///< Signaled by pop() and close()
+};
+}
+#endif /* _PATH_WALKQUEUE_H_ */
@@ -2,6 +2,8 @@
  * @file Canonical.cpp
  */
 #include <path/Canonical.h>
+#include <path/RulesBase.h>
+#include <cstdint>
 #include <iostream>
 #include <algorithm>
 #include <iterator>
@@ -17,7 +19,11 @@ Canonical::Canonical()
       m_extra(),
       m_drive(),
       m_abs(false),
-      m_components()
+      m_components(),
+      m_packed(false),
+      m_buffer(),
+      m_ends(),
+      m_plain(0)
 
 {
 }
@@ -31,10 +37,37 @@ Canonical::Canonical(const Canonical &copy)
       m_extra(copy.m_extra),
       m_drive(copy.m_drive),
       m_abs(copy.m_abs),
-      m_components(copy.m_components)
+      m_components(copy.m_components),
+      m_packed(copy.m_packed),
+      m_buffer(copy.m_buffer),
+      m_ends(copy.m_ends),
+      m_plain(copy.m_plain)
 {
 }
 
+/**
+ * Takes over all the strings from copy.  copy is
+ * left with no components.
+ *
+ * @param copy Provides the protocol, host, and component info
+ */
+Canonical::Canonical(Canonical &&copy) noexcept
+    : m_protocol(std::move(copy.m_protocol)),
+      m_host(std::move(copy.m_host)),
+      m_extra(std::move(copy.m_extra)),
+      m_drive(std::move(copy.m_drive)),
+      m_abs(copy.m_abs),
+      m_components(std::move(copy.m_components)),
+      m_packed(copy.m_packed),
+      m_buffer(std::move(copy.m_buffer)),
+      m_ends(std::move(copy.m_ends)),
+      m_plain(copy.m_plain)
+{
+    copy.m_components.clear();
+    copy.m_buffer.clear();
+    copy.m_ends.clear();
+}
+
 /**
  * Easy way to copy basic info but with a new path
  *
@@ -47,8 +80,14 @@ Canonical::Canonical(const Canonical &copy, const Strings &components)
       m_extra(copy.m_extra),
       m_drive(copy.m_drive),
       m_abs(copy.m_abs),
-      m_components(components)
+      m_components(components),
+      m_packed(false),
+      m_buffer(),
+      m_ends(),
+      m_plain(0)
 {
+    if (copy.m_packed)
+        pack();
 }
 
 /**
@@ -62,7 +101,11 @@ Canonical::Canonical(const std::string &dir1)
       m_extra(),
       m_drive(),
       m_abs(false),
-      m_components()
+      m_components(),
+      m_packed(false),
+      m_buffer(),
+      m_ends(),
+      m_plain(0)
 
 {
     add(dir1);
@@ -80,7 +123,11 @@ Canonical::Canonical(const std::string &dir1, const std::string &dir2)
       m_extra(),
       m_drive(),
       m_abs(false),
-      m_components()
+      m_components(),
+      m_packed(false),
+      m_buffer(),
+      m_ends(),
+      m_plain(0)
 
 {
     add(dir1).add(dir2);
@@ -99,7 +146,11 @@ Canonical::Canonical(const std::string &dir1, const std::string &dir2, const std
       m_extra(),
       m_drive(),
       m_abs(false),
-      m_components()
+      m_components(),
+      m_packed(false),
+      m_buffer(),
+      m_ends(),
+      m_plain(0)
 
 {
     add(dir1).add(dir2).add(dir3);
@@ -118,7 +169,11 @@ Canonical::Canonical(const std::string &dir1, const std::string &dir2, const std
       m_extra(),
       m_drive(),
       m_abs(false),
-      m_components()
+      m_components(),
+      m_packed(false),
+      m_buffer(),
+      m_ends(),
+      m_plain(0)
 
 {
     add(dir1).add(dir2).add(dir3).add(dir4);
@@ -145,10 +200,40 @@ Canonical & Canonical::operator=(const Canonical &op2)
     m_extra = op2.m_extra;
     m_drive = op2.m_drive;
     m_abs = op2.m_abs;
+    m_packed = op2.m_packed;
+    m_buffer = op2.m_buffer;
+    m_ends = op2.m_ends;
+    m_plain = op2.m_plain;
     m_components = op2.m_components;
     return *this;
 }
 
+/**
+ * Takes over all the strings from op2.
+ *
+ * @param op2 The right hand side for assignment
+ * @return A reference to this object.
+ */
+Canonical & Canonical::operator=(Canonical &&op2) noexcept
+{
+    if (this == &op2)
+        return *this;
+    m_protocol = std::move(op2.m_protocol);
+    m_host = std::move(op2.m_host);
+    m_extra = std::move(op2.m_extra);
+    m_drive = std::move(op2.m_drive);
+    m_abs = op2.m_abs;
+    m_packed = op2.m_packed;
+    m_components = std::move(op2.m_components);
+    m_buffer = std::move(op2.m_buffer);
+    m_ends = std::move(op2.m_ends);
+    m_plain = op2.m_plain;
+    op2.m_components.clear();
+    op2.m_buffer.clear();
+    op2.m_ends.clear();
+    return *this;
+}
+
 /**
  * This makes it easier to start with a given Canonical but provide
  * new components and drive.
@@ -256,8 +341,104 @@ const std::string &Canonical::drive() const
  */
 Canonical & Canonical::add(const std::string &dir)
 {
-    if (!dir.empty())
-        m_components.push_back(dir);
+    return add(std::string_view(dir));
+}
+
+/**
+ * Same as add() but dir is moved into the list of components
+ * instead of copied.
+ *
+ * @param dir The component to append
+ * @return A reference to this object
+ */
+Canonical & Canonical::add(std::string &&dir)
+{
+    if (dir.empty() || m_packed)
+        return add(std::string_view(dir));
+    if (m_plain && m_plain->needsQuote(dir))
+        m_plain = 0;
+    m_components.push_back(std::move(dir));
+    return *this;
+}
+
+/**
+ * Same as add() but avoids creating a std::string when packed().
+ *
+ * @param dir The component to append
+ * @return A reference to this object
+ */
+Canonical & Canonical::add(std::string_view dir)
+{
+    if (dir.empty())
+        return *this;
+    if (m_plain && m_plain->needsQuote(dir))
+        m_plain = 0;
+    if (m_packed)
+    {
+        m_buffer.append(dir.data(), dir.size());
+        m_ends.push_back(static_cast<unsigned int>(m_buffer.size()));
+    }
+    else
+    {
+        m_components.push_back(std::string(dir));
+    }
+    return *this;
+}
+
+/**
+ * @param dir The NUL terminated component to append
+ * @return A reference to this object
+ */
+Canonical & Canonical::add(const char *dir)
+{
+    return add(std::string_view(dir));
+}
+
+/**
+ * Appends to the last component.  If there are no
+ * components, this is the same as add().  This is used
+ * to add a suffix such as ".bak" to a filename.
+ *
+ * @param append The string to add to the last component
+ * @return A reference to this object
+ */
+Canonical & Canonical::extendLast(std::string_view append)
+{
+    if (size() == 0)
+        return add(append);
+    if (m_plain && m_plain->needsQuote(append))
+        m_plain = 0;
+    if (m_packed)
+    {
+        m_buffer.append(append.data(), append.size());
+        m_ends.back() = static_cast<unsigned int>(m_buffer.size());
+    }
+    else
+    {
+        m_components.back().append(append.data(), append.size());
+    }
+    return *this;
+}
+
+/**
+ * Removes the last component (if any).  This is how
+ * Path::dirname() is implemented.
+ *
+ * @return A reference to this object
+ */
+Canonical & Canonical::removeLast()
+{
+    if (size() == 0)
+        return *this;
+    if (m_packed)
+    {
+        m_ends.pop_back();
+        m_buffer.resize(m_ends.empty() ? 0 : m_ends.back());
+    }
+    else
+    {
+        m_components.pop_back();
+    }
     return *this;
 }
 
@@ -265,19 +446,163 @@ Canonical & Canonical::add(const std::string &dir)
  * Rather then anticipate every possible operation on the list of
  * components, this just exposes the list as a reference.
  *
+ * If this is packed() the components are first copied out of the
+ * buffer and the Canonical is no longer packed.
+ *
  * @return Componenets in a path
  */
 Strings &Canonical::components()
 {
+    // The caller might change anything
+    m_plain = 0;
+    if (m_packed)
+    {
+        unpack();
+        m_packed = false;
+        m_buffer.clear();
+        m_ends.clear();
+    }
     return m_components;
 }
 
 /**
- * @return Components in a path
+ * This doesn't change the Canonical, even if it is packed(), so
+ * it is safe to call from several threads at once.  Use view() to
+ * avoid the copy.
+ *
+ * @return A copy of the components in a path
  */
-const Strings &Canonical::components() const
+Strings Canonical::components() const
 {
-    return m_components;
+    if (!m_packed)
+        return m_components;
+    Strings copy;
+    copy.reserve(m_ends.size());
+    for (size_t i = 0; i < m_ends.size(); ++i)
+        copy.push_back(std::string(component(i)));
+    return copy;
+}
+
+/**
+ * The returned view is only valid until this Canonical is changed.
+ *
+ * @return A view of all components
+ */
+ComponentView Canonical::view() const
+{
+    return ComponentView(*this);
+}
+
+/**
+ * @param index Which component; must be less than size()
+ * @return The component without copying it
+ */
+std::string_view Canonical::component(size_t index) const
+{
+    if (!m_packed)
+        return m_components[index];
+    unsigned int start = index == 0 ? 0 : m_ends[index - 1];
+    return std::string_view(m_buffer.data() + start, m_ends[index] - start);
+}
+
+/**
+ * @return The number of components
+ */
+size_t Canonical::size() const
+{
+    return m_packed ? m_ends.size() : m_components.size();
+}
+
+/**
+ * Switches between keeping each component as a std::string
+ * and keeping all the components in a single buffer.  A packed
+ * Canonical needs two allocations no matter how many components
+ * it has.  This setting is copied along with the Canonical.
+ *
+ * @param packed True to use a single buffer
+ * @return A reference to this object
+ */
+Canonical & Canonical::setPacked(bool packed)
+{
+    if (packed == m_packed)
+        return *this;
+    if (packed)
+    {
+        pack();
+    }
+    else
+    {
+        unpack();
+        m_packed = false;
+        m_buffer.clear();
+        m_ends.clear();
+    }
+    return *this;
+}
+
+/**
+ * RulesBase::canonical() sets this so RulesBase::str() can skip
+ * checking if each component needs quote().  Adding a component
+ * that rules->needsQuote() clears it, as does calling the
+ * non-const components().
+ *
+ * @param rules The rules; NULL if not known
+ * @return A reference to this object
+ */
+Canonical & Canonical::setPlain(const RulesBase *rules)
+{
+    m_plain = rules;
+    return *this;
+}
+
+/**
+ * @return The rules no component needs to be quoted for; may be NULL
+ */
+const RulesBase *Canonical::plain() const
+{
+    return m_plain;
+}
+
+/**
+ * @return True if the components are kept in a single buffer
+ */
+bool Canonical::packed() const
+{
+    return m_packed;
+}
+
+/**
+ * Moves m_components into m_buffer and m_ends.
+ */
+void Canonical::pack()
+{
+    std::string::size_type  total = 0;
+    for (Strings::const_iterator iter = m_components.begin();
+         iter != m_components.end(); ++iter)
+        total += iter->size();
+    m_buffer.clear();
+    m_buffer.reserve(total);
+    m_ends.clear();
+    m_ends.reserve(m_components.size());
+    for (Strings::const_iterator iter = m_components.begin();
+         iter != m_components.end(); ++iter)
+    {
+        m_buffer += *iter;
+        m_ends.push_back(static_cast<unsigned int>(m_buffer.size()));
+    }
+    m_components.clear();
+    m_packed = true;
+}
+
+/**
+ * Fills in m_components from m_buffer.
+ */
+void Canonical::unpack()
+{
+    m_components.clear();
+    m_components.reserve(m_ends.size());
+    for (size_t i = 0; i < m_ends.size(); ++i)
+        m_components.push_back(std::string(component(i)));
 }
 
 /**
@@ -305,6 +630,237 @@ bool Canonical::abs() const
     return m_abs;
 }
 
+/**
+ * @param canon The Canonical to view
+ */
+ComponentView::ComponentView(const Canonical &canon)
+    : m_canon(&canon)
+{
+}
+
+size_t ComponentView::size() const
+{
+    return m_canon->size();
+}
+
+bool ComponentView::empty() const
+{
+    return m_canon->size() == 0;
+}
+
+std::string_view ComponentView::operator[](size_t index) const
+{
+    return m_canon->component(index);
+}
+
+std::string_view ComponentView::back() const
+{
+    return m_canon->component(m_canon->size() - 1);
+}
+
+ComponentView::const_iterator ComponentView::begin() const
+{
+    return const_iterator(m_canon, 0);
+}
+
+ComponentView::const_iterator ComponentView::end() const
+{
+    return const_iterator(m_canon, m_canon->size());
+}
+
+ComponentView::const_iterator::const_iterator(const Canonical *canon, size_t index)
+    : m_canon(canon),
+      m_index(index)
+{
+}
+
+std::string_view ComponentView::const_iterator::operator*() const
+{
+    return m_canon->component(m_index);
+}
+
+ComponentView::const_iterator &ComponentView::const_iterator::operator++()
+{
+    ++m_index;
+    return *this;
+}
+
+ComponentView::const_iterator ComponentView::const_iterator::operator++(int)
+{
+    const_iterator  iter(*this);
+    ++m_index;
+    return iter;
+}
+
+ComponentView::const_iterator &ComponentView::const_iterator::operator--()
+{
+    --m_index;
+    return *this;
+}
+
+ComponentView::const_iterator ComponentView::const_iterator::operator--(int)
+{
+    const_iterator  iter(*this);
+    --m_index;
+    return iter;
+}
+
+ComponentView::const_iterator &ComponentView::const_iterator::operator+=(difference_type n)
+{
+    m_index += n;
+    return *this;
+}
+
+ComponentView::const_iterator &ComponentView::const_iterator::operator-=(difference_type n)
+{
+    m_index -= n;
+    return *this;
+}
+
+ComponentView::const_iterator ComponentView::const_iterator::operator+(difference_type n) const
+{
+    return const_iterator(m_canon, m_index + n);
+}
+
+ComponentView::const_iterator ComponentView::const_iterator::operator-(difference_type n) const
+{
+    return const_iterator(m_canon, m_index - n);
+}
+
+ComponentView::const_iterator::difference_type
+ComponentView::const_iterator::operator-(const const_iterator &op2) const
+{
+    return static_cast<difference_type>(m_index) - static_cast<difference_type>(op2.m_index);
+}
+
+std::string_view ComponentView::const_iterator::operator[](difference_type n) const
+{
+    return m_canon->component(m_index + n);
+}
+
+bool ComponentView::const_iterator::operator==(const const_iterator &op2) const
+{
+    return m_canon == op2.m_canon && m_index == op2.m_index;
+}
+
+bool ComponentView::const_iterator::operator!=(const const_iterator &op2) const
+{
+    return !(*this == op2);
+}
+
+bool ComponentView::const_iterator::operator<(const const_iterator &op2) const
+{
+    return m_index < op2.m_index;
+}
+
+bool ComponentView::const_iterator::operator>(const const_iterator &op2) const
+{
+    return m_index > op2.m_index;
+}
+
+bool ComponentView::const_iterator::operator<=(const const_iterator &op2) const
+{
+    return m_index <= op2.m_index;
+}
+
+bool ComponentView::const_iterator::operator>=(const const_iterator &op2) const
+{
+    return m_index >= op2.m_index;
+}
+
+/**
+ * @param n Number of components to move forward
+ * @param iter Where to start
+ * @return iter + n
+ */
+ComponentView::const_iterator operator+(ComponentView::const_iterator::difference_type n,
+                                        const ComponentView::const_iterator &iter)
+{
+    return iter + n;
+}
+
+/**
+ * Add the bytes of str to a FNV-1a hash.  The length is
+ * added, too, so ("ab", "c") and ("a", "bc") are different.
+ *
+ * @param h The hash so far
+ * @param str The bytes to add
+ * @return The new hash
+ */
+static uint64_t hashBytes(uint64_t h, std::string_view str)
+{
+    const uint64_t  prime = 0x100000001b3ULL;
+    for (std::string_view::const_iterator iter = str.begin(); iter != str.end(); ++iter)
+        h = (h ^ static_cast<unsigned char>(*iter)) * prime;
+    return (h ^ str.size()) * prime;
+}
+
+/**
+ * The hash is FNV-1a over every value followed by a final mix
+ * so the low bits are well distributed for power of two sized
+ * hash tables.  It is the same for any two Canonical objects
+ * that compare equal.
+ *
+ * @return The hash value
+ */
+size_t Canonical::hash() const
+{
+    uint64_t    h = 0xcbf29ce484222325ULL;
+
+    h = hashBytes(h, m_protocol);
+    h = hashBytes(h, m_host);
+    h = hashBytes(h, m_extra);
+    h = hashBytes(h, m_drive);
+    h = (h ^ m_abs) * 0x100000001b3ULL;
+    ComponentView comp = view();
+    for (ComponentView::const_iterator iter = comp.begin(); iter != comp.end(); ++iter)
+        h = hashBytes(h, *iter);
+
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return static_cast<size_t>(h);
+}
+
+/**
+ * Compares abs(), protocol(), host(), extra(), drive() and then
+ * each component in turn.  Components are compared bytewise
+ * and a shorter path comes before a longer one with the same
+ * leading components.
+ *
+ * @param op2 The Canonical to compare to
+ * @return Negative if this comes first, 0 if equal, otherwise positive
+ */
+int Canonical::compare(const Canonical &op2) const
+{
+    if (m_abs != op2.m_abs)
+        return m_abs ? 1 : -1;
+    int     r;
+    if ((r = m_protocol.compare(op2.m_protocol)) != 0)
+        return r;
+    if ((r = m_host.compare(op2.m_host)) != 0)
+        return r;
+    if ((r = m_extra.compare(op2.m_extra)) != 0)
+        return r;
+    if ((r = m_drive.compare(op2.m_drive)) != 0)
+        return r;
+
+    ComponentView c1 = view();
+    ComponentView c2 = op2.view();
+    ComponentView::const_iterator i1 = c1.begin();
+    ComponentView::const_iterator i2 = c2.begin();
+    for (; i1 != c1.end() && i2 != c2.end(); ++i1, ++i2)
+    {
+        if ((r = (*i1).compare(*i2)) != 0)
+            return r;
+    }
+    if (i1 != c1.end())
+        return 1;
+    if (i2 != c2.end())
+        return -1;
+    return 0;
 }
 
 /**
@@ -352,9 +908,10 @@ operator<<(std::ostream &out, const path::Canonical &canon)
     }
     if (canon.abs())
         out << '/';
-    std::copy(canon.components().begin(),
-              canon.components().end(),
-              std::ostream_iterator<std::string>(out, "/"));
+    path::ComponentView view = canon.view();
+    for (path::ComponentView::const_iterator iter = view.begin();
+         iter != view.end(); ++iter)
+        out << *iter << '/';
     return out;
 }
 
@@ -378,9 +935,9 @@ bool operator==(const path::Canonical &op1, const path::Canonical &op2)
         return false;
     if (op1.drive() != op2.drive())
         return false;
-    if (op1.components() != op2.components())
+    if (op1.size() != op2.size())
         return false;
-    return true;
+    return std::equal(op1.view().begin(), op1.view().end(), op2.view().begin());
 }
 
 /**
@@ -395,3 +952,16 @@ bool operator!=(const path::Canonical &op1, const path::Canonical &op2)
 {
     return !(op1 == op2);
 }
+
+/**
+ * Lexicographically compare the values.  See Canonical::compare().
+ *
+ * @param op1 The left hand side
+ * @param op2 The right hand side
+ * @return true if op1 is before op2
+ */
+bool operator<(const path::Canonical &op1, const path::Canonical &op2)
+{
+    return op1.compare(op2) < 0;
+}
+}
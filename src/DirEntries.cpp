@@ -0,0 +1,298 @@
+/**
+ * @file DirEntries.cpp
+ */
+#include <path/DirEntries.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace path {
+namespace {
+/// What the radix sort moves around instead of the names
+struct SortKey
+{
+    const unsigned char *name;
+    size_t              length;
+    size_t              index;
+};
+
+/// Buckets below this size are insertion sorted
+const size_t s_radixCutoff = 32;
+
+/**
+ * @return The byte at depth plus one or 0 past the end of the name
+ */
+inline unsigned keyByte(const SortKey &key, size_t depth)
+{
+    return depth < key.length ? key.name[depth] + 1u : 0u;
+}
+
+/**
+ * Compares the names from depth on; the bytes before are the same.
+ */
+inline bool keyLess(const SortKey &a, const SortKey &b, size_t depth)
+{
+    size_t  la = a.length - depth;
+    size_t  lb = b.length - depth;
+    int     cmp = std::memcmp(a.name + depth, b.name + depth, std::min(la, lb));
+    return cmp < 0 || (cmp == 0 && la < lb);
+}
+
+/**
+ * Most significant byte first radix sort.  Every key from
+ * first to first + count shares the same first depth bytes.
+ * A byte all of them share is skipped without recursing so
+ * long common prefixes don't use up the stack.
+ */
+void radixSort(SortKey *first, SortKey *temp, size_t count, size_t depth)
+{
+    for (;;)
+    {
+        if (count < s_radixCutoff)
+        {
+            for (size_t i = 1; i < count; ++i)
+            {
+                SortKey key = first[i];
+                size_t  j = i;
+                for (; j > 0 && keyLess(key, first[j - 1], depth); --j)
+                    first[j] = first[j - 1];
+                first[j] = key;
+            }
+            return;
+        }
+        size_t  sizes[257] = { 0 };
+        for (size_t i = 0; i < count; ++i)
+            ++sizes[keyByte(first[i], depth)];
+        // Every name has the same byte here (and it can't be the end)
+        if (sizes[keyByte(first[0], depth)] == count)
+        {
+            if (keyByte(first[0], depth) == 0)
+                return;
+            ++depth;
+            continue;
+        }
+        size_t  starts[257];
+        size_t  start = 0;
+        for (size_t b = 0; b < 257; ++b)
+        {
+            starts[b] = start;
+            start += sizes[b];
+        }
+        for (size_t i = 0; i < count; ++i)
+            temp[starts[keyByte(first[i], depth)]++] = first[i];
+        std::copy(temp, temp + count, first);
+        // Names that ended (bucket 0) are all the same
+        start = sizes[0];
+        for (size_t b = 1; b < 257; ++b)
+        {
+            if (sizes[b] > 1)
+                radixSort(first + start, temp + start, sizes[b], depth + 1);
+            start += sizes[b];
+        }
+        return;
+    }
+}
+
+/**
+ * Compares a and b with each run of digits compared by its
+ * value.  When the values are the same the run with fewer
+ * leading zeros comes first, then everything else is compared
+ * byte by byte.
+ */
+bool naturalLess(std::string_view a, std::string_view b)
+{
+    size_t  i = 0;
+    size_t  j = 0;
+    int     zeros = 0;
+    while (i < a.size() && j < b.size())
+    {
+        unsigned char   ca = a[i];
+        unsigned char   cb = b[j];
+        bool            da = ca >= '0' && ca <= '9';
+        bool            db = cb >= '0' && cb <= '9';
+        if (!da || !db)
+        {
+            if (ca != cb)
+                return ca < cb;
+            ++i;
+            ++j;
+            continue;
+        }
+        size_t  za = i;
+        size_t  zb = j;
+        while (za < a.size() && a[za] == '0')
+            ++za;
+        while (zb < b.size() && b[zb] == '0')
+            ++zb;
+        size_t  ea = za;
+        size_t  eb = zb;
+        while (ea < a.size() && a[ea] >= '0' && a[ea] <= '9')
+            ++ea;
+        while (eb < b.size() && b[eb] >= '0' && b[eb] <= '9')
+            ++eb;
+        // A longer run without leading zeros is a bigger number
+        if (ea - za != eb - zb)
+            return ea - za < eb - zb;
+        int cmp = a.compare(za, ea - za, b.substr(zb, eb - zb));
+        if (cmp != 0)
+            return cmp < 0;
+        if (zeros == 0)
+            zeros = int(za - i) - int(zb - j);
+        i = ea;
+        j = eb;
+    }
+    if (a.size() - i != b.size() - j)
+        return a.size() - i < b.size() - j;
+    return zeros < 0;
+}
+}
+/**
+ * Nothing is allocated until the first entry is added.
+ */
+DirEntries::DirEntries()
+    : m_buffer(),
+      m_used(0),
+      m_records()
+{
+}
+
+DirEntries::~DirEntries()
+{
+}
+
+/**
+ * @return The number of entries
+ */
+size_t DirEntries::size() const
+{
+    return m_records.size();
+}
+
+/**
+ * @return True if there are no entries
+ */
+bool DirEntries::empty() const
+{
+    return m_records.empty();
+}
+
+/**
+ * @param index Which entry (0 to size() - 1)
+ * @return The entry; the name refers to this object
+ */
+DirEntry DirEntries::operator[](size_t index) const
+{
+    const Record &  r = m_records[index];
+    DirEntry        entry;
+    entry.name = std::string_view(m_buffer.data() + r.m_offset, r.m_length);
+    entry.type = r.m_type;
+    entry.inode = r.m_inode;
+    return entry;
+}
+
+/**
+ * Removes the entries.  The memory is kept so the next
+ * directory read into this object doesn't need to allocate.
+ */
+void DirEntries::clear()
+{
+    m_used = 0;
+    m_records.clear();
+}
+
+/**
+ * The names are never copied.  BYTEWISE uses a radix sort on
+ * the names in place, which for a large directory is much
+ * faster than comparing them with std::sort().
+ *
+ * @param order Set to the indexes (for operator[]) in order
+ * @param how How to order them
+ */
+void DirEntries::sort(std::vector<size_t> &order, SortOrder how) const
+{
+    order.resize(m_records.size());
+    if (how == BYTEWISE && order.size() > 1)
+    {
+        std::vector<SortKey>    keys(m_records.size());
+        for (size_t i = 0; i < keys.size(); ++i)
+        {
+            keys[i].name = reinterpret_cast<const unsigned char *>(m_buffer.data() + m_records[i].m_offset);
+            keys[i].length = m_records[i].m_length;
+            keys[i].index = i;
+        }
+        std::vector<SortKey>    temp(keys.size());
+        radixSort(keys.data(), temp.data(), keys.size(), 0);
+        for (size_t i = 0; i < keys.size(); ++i)
+            order[i] = keys[i].index;
+        return;
+    }
+    for (size_t i = 0; i < order.size(); ++i)
+        order[i] = i;
+    if (how == NATURAL)
+    {
+        std::sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+            return naturalLess((*this)[a].name, (*this)[b].name);
+        });
+    }
+}
+
+/**
+ * Used by systems that return one entry at a time.
+ *
+ * @param name The name of the entry; it is copied
+ * @param type The type (or NodeInfo::UNKNOWN)
+ * @param inode The inode number (or 0)
+ */
+void DirEntries::add(std::string_view name, NodeInfo::Type type, uint64_t inode)
+{
+    size_t  offset = m_used;
+    char    *dest = space(name.size() + 1);
+    std::memcpy(dest, name.data(), name.size());
+    dest[name.size()] = '\0';
+    commit(name.size() + 1);
+    addAt(offset, name.size(), type, inode);
+}
+
+/**
+ * Used by systems that read many entries at once straight into
+ * the buffer.  The pointer is only valid until the next call to
+ * space() so use offsets from used() to refer to the names.
+ *
+ * @param bytes How many bytes are needed
+ * @return Where to write them
+ */
+char *DirEntries::space(size_t bytes)
+{
+    if (m_buffer.size() < m_used + bytes)
+        m_buffer.resize(std::max(m_used + bytes, m_buffer.size() * 2));
+    return m_buffer.data() + m_used;
+}
+
+/**
+ * @param bytes How many of the bytes from space() were filled in
+ */
+void DirEntries::commit(size_t bytes)
+{
+    m_used += bytes;
+}
+
+/**
+ * @return The offset space() returns a pointer to
+ */
+size_t DirEntries::used() const
+{
+    return m_used;
+}
+
+/**
+ * @param offset Start of the name in the buffer
+ * @param length Length of the name, which must be followed by a '\0'
+ * @param type The type (or NodeInfo::UNKNOWN)
+ * @param inode The inode number (or 0)
+ */
+void DirEntries::addAt(size_t offset, size_t length, NodeInfo::Type type, uint64_t inode)
+{
+    Record  r = { offset, length, type, inode };
+    m_records.push_back(r);
+}
+}
@@ -1,5 +1,13 @@
+/**
+ * @file Glob.cpp
+ */
 #include <path/Glob.h>
 
+#include <algorithm>
+#include <bitset>
+#include <cstdint>
+#include <iterator>
+#include <unordered_map>
 #include <vector>
 
 namespace path
@@ -8,154 +16,909 @@ namespace path
  * Contains the finite state automata to recognize
  * a shell style file pattern.  This is a structure private to
  * Glob.
+ *
+ * Each state is a row of m_width entries, one per byte class.
+ * The entries are the offset of the next state's row so the next
+ * state is just m_table[state + m_classes[byte]].  State 0 is the
+ * dead state that every entry of loops back to.  Any other state
+ * that can't be left, like the one after the "*" in "a*", comes
+ * right after it so matching can stop as soon as it gets to one.
+ *
+ * When several patterns are combined for GlobSet, getting to the
+ * trailing '*' of one like "*_backup_*" means it has matched,
+ * whatever follows.  Rather than that being part of every state
+ * after it, which would make a state for each combination of the
+ * patterns matched so far, the transition is marked with s_emit
+ * and the pattern is listed for it in m_edgeMatches.
+ */
+struct Glob::Pattern : public RefcountBase
+{
+    /// The class of each byte
+    unsigned char           m_classes[256];
+    /// Number of byte classes and so entries in a row
+    unsigned                m_width;
+    /// Offset of the starting state's row
+    uint32_t                m_start;
+    /// Offset of the first state that can be left
+    uint32_t                m_sinks;
+    /// Offset of each state's next state by class
+    std::vector<uint32_t>   m_table;
+    /// Whether each state (row) accepts the word
+    std::vector<char>       m_accept;
+    /// Where each row's patterns start in m_matches, plus one at the end
+    std::vector<uint32_t>   m_firstMatch;
+    /// Index of each pattern each row matches (for GlobSet)
+    std::vector<uint32_t>   m_matches;
+    /// Table entries marked with s_emit, in order
+    std::vector<uint32_t>   m_edges;
+    /// Where each of m_edges' patterns start in m_edgeMatches, plus one at the end
+    std::vector<uint32_t>   m_edgeFirst;
+    /// Index of each pattern that has matched once an edge is taken
+    std::vector<uint32_t>   m_edgeMatches;
+    /// Length of the regular characters every match starts with
+    size_t                  m_prefix;
+    /// What every match ends with, after the prefix
+    std::string             m_suffix;
+    /// Longest run of regular characters every match has between the two
+    std::string             m_literal;
+    /// True if m_suffix or m_literal isn't empty
+    bool                    m_filter;
+
+    /// Return true if word can't match because it is missing the literals
+    bool rejects(std::string_view word) const;
+    /// Add the patterns that matched by taking table entry to which
+    void emit(uint32_t entry, std::vector<size_t> &which) const;
+
+    /// Set in a table entry after which one or more patterns have matched
+    static const uint32_t   s_emit = 0x80000000;
+};
+
+/**
+ * Most words don't end with the suffix or contain the literal so
+ * this is much quicker than the automaton for them; find() uses
+ * memchr() to look for the literal's first character.  A word
+ * without the prefix already gets to the dead state as soon as it
+ * differs so that is only used for the length.
+ *
+ * @param word The word being matched
+ * @return true if word can't match
  */
-struct Glob::Pattern
+bool Glob::Pattern::rejects(std::string_view word) const
 {
-    enum CharClass
+    size_t  fixed = m_prefix + m_suffix.size();
+    if (word.size() < fixed)
+        return true;
+    if (!m_suffix.empty() && word.substr(word.size() - m_suffix.size()) != m_suffix)
+        return true;
+    return !m_literal.empty()
+        && word.substr(m_prefix, word.size() - fixed).find(m_literal) == std::string_view::npos;
+}
+
+/**
+ * @param entry Index in m_table of an entry marked with s_emit
+ * @param which The patterns are added to this
+ */
+void Glob::Pattern::emit(uint32_t entry, std::vector<size_t> &which) const
+{
+    size_t  i = std::lower_bound(m_edges.begin(), m_edges.end(), entry) - m_edges.begin();
+    which.insert(which.end(), m_edgeMatches.begin() + m_edgeFirst[i],
+                 m_edgeMatches.begin() + m_edgeFirst[i + 1]);
+}
+
+namespace {
+/// A set of bytes that a single transition accepts
+typedef std::bitset<256> ByteSet;
+
+/**
+ * Nondeterministic automaton the pattern is parsed into.  Each
+ * state has at most one transition on a set of bytes plus any
+ * number of empty (epsilon) transitions.
+ */
+struct Nfa
+{
+    struct State
     {
-        CHAR_CLASS_ANY,
-        CHAR_CLASS_ONE,
-        CHAR_CLASS_LIST,
-        CHAR_CLASS_RANGE
+        int                 m_set;      ///< Index in m_sets or -1
+        int                 m_next;     ///< State after a byte in m_set
+        std::vector<int>    m_empty;    ///< States reached without a byte
     };
-    union Chars
+    std::vector<State>      m_states;
+    std::vector<ByteSet>    m_sets;
+
+    /// Return a new state with no transitions
+    int add()
     {
-        char        m_one;
-        char        m_range[2];
-        char *      m_list;
-    };
-    struct Transition
+        State   s = { -1, -1, std::vector<int>() };
+        m_states.push_back(s);
+        return int(m_states.size() - 1);
+    }
+    /// Move from state to next on any byte in set
+    void transition(int state, const ByteSet &set, int next)
+    {
+        size_t  i = std::find(m_sets.begin(), m_sets.end(), set) - m_sets.begin();
+        if (i == m_sets.size())
+            m_sets.push_back(set);
+        m_states[state].m_set = int(i);
+        m_states[state].m_next = next;
+    }
+    /// Move from state to next without a byte
+    void empty(int state, int next)
+    {
+        m_states[state].m_empty.push_back(next);
+    }
+};
+
+/**
+ * Recursive descent parser that turns a pattern into an Nfa.
+ */
+class GlobParser
+{
+public:
+    GlobParser(const std::string &pattern, Nfa &nfa)
+        : m_pattern(pattern), m_pos(0), m_nfa(nfa), m_depth(0), m_runs(1)
+    {
+    }
+    /// Parse from pos; return false if the pattern is malformed
+    bool parse(size_t pos, int &start, int &end)
     {
-        Transition();
-        ~Transition();
-        bool match (char ch) const
+        m_pos = pos;
+        start = m_nfa.add();
+        if (!sequence(start, end))
+            return false;
+        return m_pos == m_pattern.size();
+    }
+    /**
+     * The regular characters outside of braces, split wherever
+     * anything else is; the first is what every match starts with
+     * and, if there is more than one, the last is what it ends with.
+     */
+    const std::vector<std::string> &runs() const
+    {
+        return m_runs;
+    }
+private:
+    /// Parse until the end or, inside braces, a ',' or '}'
+    bool sequence(int start, int &end);
+    /// Parse a {...} starting after the '{'
+    bool braces(int start, int &end);
+    /// Parse a [...] starting after the '['; false if there is no ']'
+    bool bracket(ByteSet &result);
+
+    const std::string & m_pattern;
+    size_t              m_pos;
+    Nfa &               m_nfa;
+    int                 m_depth;    ///< How many braces we are in
+    std::vector<std::string> m_runs;
+};
+
+bool GlobParser::sequence(int start, int &end)
+{
+    int     cur = start;
+    while (m_pos < m_pattern.size())
+    {
+        unsigned char   ch = m_pattern[m_pos];
+        ByteSet         set;
+        if (m_depth > 0 && (ch == ',' || ch == '}'))
+            break;
+        ++m_pos;
+        switch (ch)
+        {
+        case '*':
         {
-            switch (m_type)
+            // Loop on any byte then carry on without one
+            int next = m_nfa.add();
+            m_nfa.transition(cur, ByteSet().set(), cur);
+            m_nfa.empty(cur, next);
+            cur = next;
+            if (m_depth == 0)
+                m_runs.push_back(std::string());
+            continue;
+        }
+        case '?':
+            set.set();
+            break;
+        case '[':
+        {
+            size_t  open = m_pos;
+            if (!bracket(set))
             {
-            case CHAR_CLASS_ANY:
-                return true;
-            case CHAR_CLASS_ONE:
-                return m_input.m_one == ch;
-            case CHAR_CLASS_RANGE:
-                return m_input.m_range[0] <= ch && m_input.m_range[1] >= ch;
-            case CHAR_CLASS_LIST:
-                for(const char *p = m_input.m_list; *p; ++p)
-                {
-                    if (*p == ch)
-                        return true;
-                }
-                return false;
+                m_pos = open;
+                set.set('[');
+            }
+            break;
+        }
+        case '{':
+            if (m_pos < m_pattern.size() && m_pattern[m_pos] == '}')
+            {
+                // "{}" is just those characters
+                int next = m_nfa.add();
+                m_nfa.transition(cur, ByteSet().set('{'), next);
+                cur = next;
+                if (m_depth == 0)
+                    m_runs.back() += '{';
+                ch = '}';
+                ++m_pos;
+                set.set(ch);
+                break;
             }
+            if (m_depth == 0)
+                m_runs.push_back(std::string());
+            if (!braces(cur, cur))
+                return false;
+            continue;
+        case '\\':
+            if (m_pos < m_pattern.size())
+                ch = m_pattern[m_pos++];
+            set.set(ch);
+            break;
+        default:
+            set.set(ch);
+            break;
+        }
+        if (m_depth == 0)
+        {
+            // A single byte carries on the run of regular characters
+            if (set.count() == 1 && set.test(ch))
+                m_runs.back() += char(ch);
+            else
+                m_runs.push_back(std::string());
+        }
+        int next = m_nfa.add();
+        m_nfa.transition(cur, set, next);
+        cur = next;
+    }
+    end = cur;
+    return true;
+}
+
+bool GlobParser::braces(int start, int &end)
+{
+    ++m_depth;
+    end = m_nfa.add();
+    for (;;)
+    {
+        int first = m_nfa.add();
+        int last;
+        m_nfa.empty(start, first);
+        if (!sequence(first, last))
             return false;
+        m_nfa.empty(last, end);
+        if (m_pos >= m_pattern.size())
+            return false;       // Missing }
+        if (m_pattern[m_pos++] == '}')
+            break;
+    }
+    --m_depth;
+    return true;
+}
+
+bool GlobParser::bracket(ByteSet &result)
+{
+    ByteSet set;
+    bool    negate = false;
+    if (m_pos < m_pattern.size() && (m_pattern[m_pos] == '^' || m_pattern[m_pos] == '!'))
+    {
+        negate = true;
+        ++m_pos;
+    }
+    bool    first = true;
+    for (;;)
+    {
+        if (m_pos >= m_pattern.size())
+            return false;
+        unsigned char   lo = m_pattern[m_pos++];
+        if (lo == ']' && !first)
+            break;
+        first = false;
+        if (lo == '\\' && m_pos < m_pattern.size())
+            lo = m_pattern[m_pos++];
+        unsigned char   hi = lo;
+        if (m_pos + 1 < m_pattern.size() && m_pattern[m_pos] == '-' && m_pattern[m_pos + 1] != ']')
+        {
+            hi = m_pattern[m_pos + 1];
+            m_pos += 2;
+            if (hi == '\\' && m_pos < m_pattern.size())
+                hi = m_pattern[m_pos++];
         }
-        int             m_next;
-        CharClass       m_type;
-        Chars           m_input;
-    };
-    typedef std::vector<Transition>     Transitions;
-    struct State
+        // A backwards range matches nothing
+        for (unsigned c = lo; c <= hi; ++c)
+            set.set(c);
+    }
+    if (negate)
+        set.flip();
+    result = set;
+    return true;
+}
+
+/**
+ * Adds everything reachable from the states in set without
+ * reading a byte.  The result is sorted.  seen has an entry for
+ * each state of nfa and is all zero before and after so the cost
+ * depends on the size of set rather than of nfa.
+ */
+void closure(const Nfa &nfa, std::vector<int> &set, std::vector<char> &seen)
+{
+    // set is its own work list; states are only added once
+    size_t  count = 0;
+    for (size_t i = 0; i < set.size(); ++i)
     {
-        State();
-        ~State();
-        int             m_fail;
-        Transitions     m_trans;
-    };
-    typedef std::vector<State>          States;
+        if (!seen[set[i]])
+        {
+            seen[set[i]] = 1;
+            set[count++] = set[i];
+        }
+    }
+    set.resize(count);
+    for (size_t i = 0; i < set.size(); ++i)
+    {
+        const std::vector<int> &empty = nfa.m_states[set[i]].m_empty;
+        for (std::vector<int>::const_iterator e = empty.begin(); e != empty.end(); ++e)
+        {
+            if (!seen[*e])
+            {
+                seen[*e] = 1;
+                set.push_back(*e);
+            }
+        }
+    }
+    for (std::vector<int>::const_iterator s = set.begin(); s != set.end(); ++s)
+        seen[*s] = 0;
+    std::sort(set.begin(), set.end());
+}
 
-    States      m_states;
+/**
+ * Splits the bytes into classes by which of the sets of nfa they
+ * are in, on top of however classes already splits them.
+ *
+ * @param nfa The automaton with the sets of bytes
+ * @param classes The class of each byte, all 0 to start afresh
+ * @return The number of classes
+ */
+unsigned splitClasses(const Nfa &nfa, unsigned char classes[256])
+{
+    unsigned    width = 1 + *std::max_element(classes, classes + 256);
+    for (std::vector<ByteSet>::const_iterator s = nfa.m_sets.begin(); s != nfa.m_sets.end(); ++s)
+    {
+        int     split[256][2];
+        std::fill(&split[0][0], &split[0][0] + 512, -1);
+        unsigned    count = 0;
+        for (unsigned c = 0; c < 256; ++c)
+        {
+            int &to = split[classes[c]][s->test(c)];
+            if (to < 0)
+                to = int(count++);
+            classes[c] = static_cast<unsigned char>(to);
+        }
+        width = count;
+    }
+    return width;
+}
+
+/// Hash of a sorted set of Nfa states
+struct SetHash
+{
+    size_t operator()(const std::vector<int> &set) const
+    {
+        size_t  h = 14695981039346656037ULL;
+        for (std::vector<int>::const_iterator s = set.begin(); s != set.end(); ++s)
+            h = (h ^ size_t(*s)) * 1099511628211ULL;
+        return h;
+    }
 };
+}
+
+/**
+ * Renumbers the states of p so the ones that every byte leads
+ * back to come first.
+ */
+void Glob::sinksFirst(Pattern &p)
+{
+    unsigned    width = p.m_width;
+    size_t      rows = p.m_accept.size();
+    std::vector<uint32_t>   order;
+    for (int sink = 1; sink >= 0; --sink)
+    {
+        for (size_t row = 0; row < rows; ++row)
+        {
+            const uint32_t  *next = &p.m_table[row * width];
+            // An entry marked with s_emit never equals the row
+            bool    loops = std::count(next, next + width, uint32_t(row * width)) == width;
+            if (loops == bool(sink))
+                order.push_back(uint32_t(row));
+        }
+        if (sink)
+            p.m_sinks = uint32_t(order.size() * width);
+    }
+    std::vector<uint32_t>   moved(rows);
+    for (size_t i = 0; i < rows; ++i)
+        moved[order[i]] = uint32_t(i * width);
+    std::vector<uint32_t>   table(p.m_table.size());
+    std::vector<char>       accept(rows);
+    std::vector<uint32_t>   firstMatch(1, 0);
+    std::vector<uint32_t>   matches;
+    for (size_t i = 0; i < rows; ++i)
+    {
+        uint32_t    row = order[i];
+        for (unsigned k = 0; k < width; ++k)
+        {
+            uint32_t    to = p.m_table[row * width + k];
+            table[i * width + k] = moved[(to & ~Pattern::s_emit) / width] | (to & Pattern::s_emit);
+        }
+        accept[i] = p.m_accept[row];
+        matches.insert(matches.end(), p.m_matches.begin() + p.m_firstMatch[row],
+                       p.m_matches.begin() + p.m_firstMatch[row + 1]);
+        firstMatch.push_back(uint32_t(matches.size()));
+    }
+    p.m_table.swap(table);
+    p.m_accept.swap(accept);
+    p.m_firstMatch.swap(firstMatch);
+    p.m_matches.swap(matches);
+    p.m_start = moved[p.m_start / width];
+
+    // The marked entries moved with their rows
+    std::vector<std::pair<uint32_t, size_t> >   edges;
+    for (size_t i = 0; i < p.m_edges.size(); ++i)
+        edges.push_back(std::make_pair(moved[p.m_edges[i] / width] + p.m_edges[i] % width, i));
+    std::sort(edges.begin(), edges.end());
+    std::vector<uint32_t>   edgeFirst(1, 0);
+    std::vector<uint32_t>   edgeMatches;
+    for (size_t i = 0; i < edges.size(); ++i)
+    {
+        size_t  old = edges[i].second;
+        p.m_edges[i] = edges[i].first;
+        edgeMatches.insert(edgeMatches.end(), p.m_edgeMatches.begin() + p.m_edgeFirst[old],
+                           p.m_edgeMatches.begin() + p.m_edgeFirst[old + 1]);
+        edgeFirst.push_back(uint32_t(edgeMatches.size()));
+    }
+    p.m_edgeFirst.swap(edgeFirst);
+    p.m_edgeMatches.swap(edgeMatches);
+}
 
 /**
  * @param pattern The csh-style file pattern
  */
 Glob::Glob (const std::string &pattern)
     : m_pattern (pattern),
-      m_compiled (0)
+      m_compiled ()
 {
+    compile();
 }
 
 /**
+ * Shares the compiled pattern with copy.
+ *
  * @param copy The Glob object to copy
  */
 Glob::Glob (const Glob &copy)
     : m_pattern (copy.m_pattern),
-      m_compiled (0)
+      m_compiled (copy.m_compiled)
+{
+}
+
+/**
+ * Used by GlobSet to match all of patterns at once.  It
+ * doesn't have a pattern() of its own.
+ *
+ * @param patterns The patterns, none starting with a '^'
+ * @param limit Most entries in the table or 0 for no limit
+ */
+Glob::Glob (const std::vector<std::string> &patterns, size_t limit)
+    : m_pattern (),
+      m_compiled ()
+{
+    build(patterns, false, true, limit);
+}
+
+/**
+ * GlobSet uses this and refine() to guess how big the table of
+ * several patterns will be before building it.
+ *
+ * @return The number of states less the dead one; 0 if malformed
+ */
+size_t Glob::rows() const
+{
+    const Pattern   *p = m_compiled.get();
+    return p ? p->m_table.size() / p->m_width - 1 : 0;
+}
+
+/**
+ * The classes of a table for several patterns are the ones that
+ * each of them splits the bytes into, split further by the others.
+ *
+ * @param pattern A pattern that is known to compile
+ * @param classes The class of each byte so far, all 0 for none
+ * @return The number of classes
+ */
+unsigned Glob::refine(const std::string &pattern, unsigned char classes[256])
 {
+    Nfa     nfa;
+    int     first;
+    int     last;
+    GlobParser(pattern, nfa).parse(0, first, last);
+    return splitClasses(nfa, classes);
 }
 
 /**
- * Clean up the m_compiled pattern
+ * The last copy cleans up the m_compiled pattern
  */
 Glob::~Glob()
 {
-    delete m_compiled;
 }
 
+/**
+ * @param op2 Right hand side
+ * @return A reference to this object
+ */
+Glob &Glob::operator=(const Glob &op2)
+{
+    m_pattern = op2.m_pattern;
+    m_compiled = op2.m_compiled;
+    return *this;
+}
+
+/**
+ * Parses the pattern into a nondeterministic automaton and then
+ * turns that into a deterministic one.
+ *
+ * @return false if the pattern is malformed
+ */
 bool Glob::compile()
 {
-    if (m_compiled)
+    if (m_compiled.get())
         return true;
-    m_compiled = new Pattern;
-    for (std::string::const_iterator iter = m_pattern.begin(); iter != m_pattern.end();
-         ++iter)
+
+    bool    negate = m_pattern.size() > 1 && m_pattern[0] == '^';
+    std::vector<std::string>    patterns(1, m_pattern.substr(negate ? 1 : 0));
+    return build(patterns, negate, false, 0);
+}
+
+/**
+ * Does the work for compile().  Each pattern is parsed into the
+ * same nondeterministic automaton with an empty transition from
+ * a shared starting state.  Bytes that every set of bytes in the
+ * patterns treats the same are put in the same class so a pattern
+ * like "*.[ch]" only needs four columns: '.', 'c', 'h' and
+ * everything else.  Each state of the deterministic automaton
+ * remembers which of the patterns it matches.  For a single
+ * pattern the regular characters a match must start with, end
+ * with and contain are also kept.  For GlobSet, a pattern that
+ * has matched no matter what follows is taken out of the states
+ * after it and listed for the transition instead.
+ *
+ * @param patterns The patterns to match
+ * @param negate Match what none of the patterns do
+ * @param emit Mark the transitions that patterns finish on with s_emit
+ * @param limit Give up if the table plus the sets of Nfa states
+ *      its rows were built from would have more entries than this
+ * @return false if a pattern is malformed or the limit was reached
+ */
+bool Glob::build(const std::vector<std::string> &patterns, bool negate, bool emit, size_t limit)
+{
+    Pattern *p = new Pattern;
+    Refcount<Pattern>   compiled(p);
+    p->m_prefix = 0;
+    p->m_filter = false;
+    Nfa     nfa;
+    int     start = nfa.add();
+    std::vector<std::pair<int, uint32_t> >  accepts;
+    // The pattern each Nfa state is part of
+    std::vector<int>    owner(1, -1);
+    for (size_t i = 0; i < patterns.size(); ++i)
     {
-        if (*iter == '*')
+        int first;
+        int last;
+        GlobParser  parser(patterns[i], nfa);
+        bool    parsed = parser.parse(0, first, last);
+        owner.resize(nfa.m_states.size(), int(i));
+        if (!parsed)
+            return false;
+        nfa.empty(start, first);
+        accepts.push_back(std::make_pair(last, uint32_t(i)));
+        if (patterns.size() > 1)
+            continue;
+        // The literal parts of a single pattern let match() skip the automaton
+        const std::vector<std::string> &runs = parser.runs();
+        p->m_prefix = runs.front().size();
+        if (runs.size() > 1)
+            p->m_suffix = runs.back();
+        for (size_t r = 1; r + 1 < runs.size(); ++r)
         {
-            Pattern::State       s;
-            
-            m_compiled->m_states.push_back (s);
+            if (runs[r].size() > p->m_literal.size())
+                p->m_literal = runs[r];
         }
+        p->m_filter = !p->m_suffix.empty() || !p->m_literal.empty();
     }
-    return true;
-}
+    std::vector<int>    accepting(nfa.m_states.size(), -1);
+    for (size_t i = 0; i < accepts.size(); ++i)
+        accepting[accepts[i].first] = int(accepts[i].second);
 
-bool Glob::match (const std::string &word)
-{
-    compile();
-    if (!m_compiled || m_compiled->m_states.empty())
-        return false;
+    unsigned char   classes[256] = { 0 };
+    unsigned        width = splitClasses(nfa, classes);
+    std::copy(classes, classes + 256, p->m_classes);
+    p->m_width = width;
+    // The classes in each set of bytes
+    std::vector<std::vector<unsigned> > setClasses(nfa.m_sets.size());
+    for (size_t i = 0; i < nfa.m_sets.size(); ++i)
+    {
+        std::vector<char>   in(width, 0);
+        for (unsigned c = 0; c < 256; ++c)
+        {
+            if (nfa.m_sets[i].test(c) && !in[classes[c]])
+            {
+                in[classes[c]] = 1;
+                setClasses[i].push_back(classes[c]);
+            }
+        }
+    }
 
-    Pattern::State *state  = &m_compiled->m_states[0];
-    for (std::string::const_iterator iter = word.begin();
-         iter != word.end(); ++iter)
+    // Subset construction; each set of Nfa states is one state.
+    // The states of a '*' at the start of a pattern, and what they
+    // lead to without a byte, are in every set since every byte
+    // leads back to them.  They are kept in base and left out of the
+    // sets so those stay small with many patterns like "*.o".
+    std::vector<char>   seen(nfa.m_states.size(), 0);
+    std::vector<int>    set(1, start);
+    closure(nfa, set, seen);
+    std::vector<int>    base;
+    for (std::vector<int>::const_iterator s = set.begin(); s != set.end(); ++s)
     {
-        if (!state)
-            return false;
-        for (Pattern::Transitions::const_iterator t = state->m_trans.begin();
-             t != state->m_trans.end(); ++t)
+        const Nfa::State &state = nfa.m_states[*s];
+        if (state.m_next == *s && nfa.m_sets[state.m_set].all())
+            base.push_back(*s);
+    }
+    closure(nfa, base, seen);
+    std::vector<char>   inBase(nfa.m_states.size(), 0);
+    std::vector<uint32_t>   baseMatches;
+    for (std::vector<int>::const_iterator s = base.begin(); s != base.end(); ++s)
+    {
+        inBase[*s] = 1;
+        if (accepting[*s] >= 0)
+            baseMatches.push_back(uint32_t(accepting[*s]));
+    }
+    // A '*' that leads to the end of its pattern, outside base, has
+    // matched that pattern whatever follows
+    std::vector<char>   sticky(nfa.m_states.size(), 0);
+    bool                anySticky = false;
+    for (size_t s = 0; emit && s < nfa.m_states.size(); ++s)
+    {
+        const Nfa::State &state = nfa.m_states[s];
+        if (inBase[s] || state.m_next != int(s) || !nfa.m_sets[state.m_set].all())
+            continue;
+        std::vector<int>    reach(1, int(s));
+        closure(nfa, reach, seen);
+        for (std::vector<int>::const_iterator r = reach.begin(); r != reach.end(); ++r)
         {
-            if (t->match (*iter))
+            if (accepting[*r] >= 0)
+                sticky[s] = 1;
+        }
+        anySticky = anySticky || sticky[s];
+    }
+    // Takes the patterns with a sticky state out of set and puts them
+    // in matched.  What base starts again on this byte stays, since
+    // that doesn't depend on which patterns have matched before.
+    std::vector<size_t> done(patterns.size(), 0);
+    size_t              stamp = 0;
+    std::vector<uint32_t>   matched;
+    auto    finished = [&](std::vector<int> &set, const std::vector<int> &restart) {
+        matched.clear();
+        ++stamp;
+        for (std::vector<int>::const_iterator s = set.begin(); s != set.end(); ++s)
+        {
+            if (sticky[*s] && done[owner[*s]] != stamp)
             {
-                state = &m_compiled->m_states[t->m_next];
-                break;
+                done[owner[*s]] = stamp;
+                matched.push_back(uint32_t(owner[*s]));
+            }
+        }
+        if (matched.empty())
+            return;
+        std::sort(matched.begin(), matched.end());
+        auto    drop = [&](int s) {
+            if (owner[s] < 0 || done[owner[s]] != stamp)
+                return false;
+            return sticky[s] || !std::binary_search(restart.begin(), restart.end(), s);
+        };
+        set.erase(std::remove_if(set.begin(), set.end(), drop), set.end());
+    };
+    // Adds where each class goes from the Nfa states in from to next
+    std::vector<std::vector<int> >  next(width);
+    auto    moves = [&](const std::vector<int> &from) {
+        for (std::vector<int>::const_iterator s = from.begin(); s != from.end(); ++s)
+        {
+            const Nfa::State &state = nfa.m_states[*s];
+            if (state.m_set < 0)
+                continue;
+            const std::vector<unsigned> &in = setClasses[state.m_set];
+            for (std::vector<unsigned>::const_iterator k = in.begin(); k != in.end(); ++k)
+                next[*k].push_back(state.m_next);
+        }
+    };
+    // Removes base from a set made by closure()
+    auto    strip = [&](std::vector<int> &set) {
+        set.erase(std::remove_if(set.begin(), set.end(),
+                                 [&](int s) { return inBase[s] != 0; }), set.end());
+    };
+    std::vector<std::vector<int> >  baseNext(width);
+    moves(base);
+    for (unsigned k = 0; k < width; ++k)
+    {
+        baseNext[k].swap(next[k]);
+        closure(nfa, baseNext[k], seen);
+        strip(baseNext[k]);
+    }
+
+    typedef std::unordered_map<std::vector<int>, uint32_t, SetHash> Ids;
+    Ids                                     ids;
+    std::vector<const std::vector<int> *>   todo;
+    size_t                                  used = 0;
+    // Adds a row for set and returns its offset
+    auto    add = [&](const std::vector<int> &set) {
+        uint32_t    offset = uint32_t(p->m_table.size());
+        todo.push_back(&ids.insert(std::make_pair(set, offset)).first->first);
+        used += width + set.size();
+        p->m_table.resize(offset + width);
+        size_t      first = p->m_matches.size();
+        p->m_matches.insert(p->m_matches.end(), baseMatches.begin(), baseMatches.end());
+        for (std::vector<int>::const_iterator s = set.begin(); s != set.end(); ++s)
+        {
+            if (accepting[*s] >= 0)
+                p->m_matches.push_back(uint32_t(accepting[*s]));
+        }
+        std::sort(p->m_matches.begin() + first, p->m_matches.end());
+        p->m_accept.push_back((p->m_matches.size() != first) != negate);
+        p->m_firstMatch.push_back(uint32_t(p->m_matches.size()));
+        return offset;
+    };
+    // The dead state
+    p->m_table.assign(width, 0);
+    p->m_accept.push_back(negate);
+    p->m_firstMatch.assign(2, 0);
+    p->m_edgeFirst.assign(1, 0);
+
+    strip(set);
+    p->m_start = add(set);
+    std::vector<int>    merged;
+    for (size_t row = 1; row <= todo.size(); ++row)
+    {
+        moves(*todo[row - 1]);
+        for (unsigned k = 0; k < width; ++k)
+        {
+            // Without base an empty set is the dead state
+            if (next[k].empty() && base.empty())
+                continue;
+            set.swap(next[k]);
+            next[k].clear();
+            closure(nfa, set, seen);
+            strip(set);
+            // baseNext is already closed so it just needs merging in
+            if (!baseNext[k].empty())
+            {
+                merged.clear();
+                std::set_union(set.begin(), set.end(), baseNext[k].begin(), baseNext[k].end(),
+                               std::back_inserter(merged));
+                set.swap(merged);
             }
+            if (anySticky)
+                finished(set, baseNext[k]);
+            Ids::const_iterator found = ids.find(set);
+            uint32_t    to;
+            if (set.empty() && base.empty())
+                to = 0;
+            else if (found != ids.end())
+                to = found->second;
+            else if (limit > 0 && used + width + set.size() > limit)
+                return false;
+            else
+                to = add(set);
+            if (anySticky && !matched.empty())
+            {
+                to |= Pattern::s_emit;
+                used += matched.size();
+                p->m_edges.push_back(uint32_t(row * width + k));
+                p->m_edgeMatches.insert(p->m_edgeMatches.end(), matched.begin(), matched.end());
+                p->m_edgeFirst.push_back(uint32_t(p->m_edgeMatches.size()));
+            }
+            p->m_table[row * width + k] = to;
         }
     }
+    sinksFirst(*p);
+    m_compiled = compiled;
     return true;
 }
 
-Glob::Pattern::Transition::Transition()
-    : m_next (-1),
-      m_type (CHAR_CLASS_ONE)
+/**
+ * @param word The word, usually a basename, to compare
+ * @return True if word matches the whole pattern
+ */
+bool Glob::match (std::string_view word) const
 {
-    m_input.m_one = '\0';
+    const Pattern   *p = m_compiled.get();
+    if (!p)
+        return false;
+    // Without the literals it is the same as getting to the dead state
+    if (p->m_filter && p->rejects(word))
+        return p->m_accept[0];
+    const uint32_t      *table = p->m_table.data();
+    const unsigned char *classes = p->m_classes;
+    uint32_t            state = p->m_start;
+    for (std::string_view::const_iterator iter = word.begin(); iter != word.end(); ++iter)
+    {
+        state = table[state + classes[static_cast<unsigned char>(*iter)]];
+        // A pattern has matched whatever else there is
+        if (state & Pattern::s_emit)
+            return !p->m_accept[0];
+        // Nothing gets out of the dead state or any other sink
+        if (state < p->m_sinks)
+            break;
+    }
+    return p->m_accept[state / p->m_width];
 }
 
-Glob::Pattern::Transition::~Transition()
+/**
+ * Used by GlobSet to find every pattern that matches word.
+ *
+ * @param word The word to compare
+ * @param which The index of each matching pattern is added to this
+ * @return How many patterns matched
+ */
+size_t Glob::matchAll (std::string_view word, std::vector<size_t> &which) const
 {
-    if (m_type == CHAR_CLASS_LIST)
-        delete [] m_input.m_list;
+    const Pattern   *p = m_compiled.get();
+    if (!p)
+        return 0;
+    const uint32_t      *table = p->m_table.data();
+    const unsigned char *classes = p->m_classes;
+    uint32_t            state = p->m_start;
+    size_t              start = which.size();
+    bool                emitted = false;
+    for (std::string_view::const_iterator iter = word.begin(); iter != word.end(); ++iter)
+    {
+        uint32_t    entry = state + classes[static_cast<unsigned char>(*iter)];
+        state = table[entry];
+        if (state & Pattern::s_emit)
+        {
+            p->emit(entry, which);
+            emitted = true;
+            state &= ~Pattern::s_emit;
+        }
+        if (state < p->m_sinks)
+            break;
+    }
+    size_t  row = state / p->m_width;
+    which.insert(which.end(), p->m_matches.begin() + p->m_firstMatch[row],
+                 p->m_matches.begin() + p->m_firstMatch[row + 1]);
+    if (emitted)
+    {
+        // A pattern can match again after it was taken out
+        std::sort(which.begin() + start, which.end());
+        which.erase(std::unique(which.begin() + start, which.end()), which.end());
+    }
+    return which.size() - start;
 }
 
-Glob::Pattern::State::State()
-    : m_fail (-1),
-      m_trans()
+/**
+ * @param word The word to compare
+ * @return True if word matches the whole pattern
+ */
+bool Glob::match (const std::string &word) const
 {
+    return match(std::string_view(word));
 }
 
-
-Glob::Pattern::State::~State()
+/**
+ * @param word The word to compare; NULL is the same as ""
+ * @return True if word matches the whole pattern
+ */
+bool Glob::match (const char *word) const
 {
+    return match(std::string_view(word ? word : ""));
 }
 
+/**
+ * @return The pattern as given to the constructor
+ */
+const std::string &Glob::pattern() const
+{
+    return m_pattern;
+}
 }
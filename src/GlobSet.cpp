@@ -0,0 +1,342 @@
+/**
+ * @file GlobSet.cpp
+ */
+#include <path/GlobSet.h>
+
+#include <algorithm>
+#include <set>
+
+namespace path {
+/**
+ * Most entries the transition table of one group, plus the sets
+ * of states it is built from, can have; about 1MB so a table
+ * stays in cache while matching.  A few thousand patterns like
+ * "*.o" or "build_*" fit easily but ones with several '*' each
+ * can make a combined automaton much bigger than the patterns.
+ */
+const size_t GlobSet::s_maxTable = 1 << 18;
+
+namespace {
+/**
+ * @param pattern A pattern that is known to compile
+ * @return True if pattern is '*' followed by regular characters
+ */
+bool isSuffix(const std::string &pattern)
+{
+    return pattern.size() > 1 && pattern[0] == '*'
+        && pattern.find_first_of("*?[{\\", 1) == std::string::npos;
+}
+
+/**
+ * @param patterns Sorted patterns
+ * @param pattern Another pattern
+ * @return The most characters pattern starts with that one of patterns does too
+ */
+size_t shared(const std::set<std::string_view> &patterns, std::string_view pattern)
+{
+    size_t  most = 0;
+    std::set<std::string_view>::const_iterator  after = patterns.lower_bound(pattern);
+    for (int i = 0; i < 2; ++i)
+    {
+        if (after != patterns.end())
+        {
+            size_t  length = std::min(after->size(), pattern.size());
+            std::string_view::const_iterator    differ =
+                std::mismatch(pattern.begin(), pattern.begin() + length, after->begin()).first;
+            most = std::max(most, size_t(differ - pattern.begin()));
+        }
+        if (after == patterns.begin())
+            break;
+        --after;
+    }
+    return most;
+}
+}
+
+GlobSet::GlobSet()
+    : m_patterns(),
+      m_rows(),
+      m_compiled(false),
+      m_suffixes(),
+      m_suffixLengths(),
+      m_groups(),
+      m_groupIndexes(),
+      m_negated()
+{
+}
+
+/**
+ * The compiled groups are shared with copy but m_suffixes is
+ * rebuilt as its keys point into the patterns.
+ *
+ * @param copy The GlobSet to copy
+ */
+GlobSet::GlobSet(const GlobSet &copy)
+    : m_patterns(copy.m_patterns),
+      m_rows(copy.m_rows),
+      m_compiled(copy.m_compiled),
+      m_suffixes(),
+      m_suffixLengths(),
+      m_groups(copy.m_groups),
+      m_groupIndexes(copy.m_groupIndexes),
+      m_negated(copy.m_negated)
+{
+    if (m_compiled)
+        indexSuffixes();
+}
+
+GlobSet::~GlobSet()
+{
+}
+
+/**
+ * @param op2 Right hand side
+ * @return A reference to this object
+ */
+GlobSet &GlobSet::operator=(const GlobSet &op2)
+{
+    if (this == &op2)
+        return *this;
+    m_patterns = op2.m_patterns;
+    m_rows = op2.m_rows;
+    m_compiled = op2.m_compiled;
+    m_groups = op2.m_groups;
+    m_groupIndexes = op2.m_groupIndexes;
+    m_negated = op2.m_negated;
+    m_suffixes.clear();
+    m_suffixLengths.clear();
+    if (m_compiled)
+        indexSuffixes();
+    return *this;
+}
+
+/**
+ * The index of the pattern is size() before it was added.
+ *
+ * @param pattern A Glob pattern
+ * @return false if pattern is malformed; it isn't added
+ */
+bool GlobSet::add(const std::string &pattern)
+{
+    // Compiled the way a group is, to see how big it is
+    size_t  rows;
+    if (pattern.size() > 1 && pattern[0] == '^')
+        rows = Glob(pattern).rows();
+    else
+        rows = Glob(std::vector<std::string>(1, pattern), 0).rows();
+    if (!rows)
+        return false;
+    // Adding may move the strings m_suffixes points into
+    if (m_compiled)
+        m_suffixes.clear();
+    m_patterns.push_back(pattern);
+    m_rows.push_back(rows);
+    m_compiled = false;
+    return true;
+}
+
+/**
+ * @return The number of patterns added
+ */
+size_t GlobSet::size() const
+{
+    return m_patterns.size();
+}
+
+/**
+ * @param index Which pattern (0 to size() - 1)
+ * @return The pattern as it was added
+ */
+const std::string &GlobSet::pattern(size_t index) const
+{
+    return m_patterns[index];
+}
+
+/**
+ * Sorts the patterns into suffixes, negated patterns and
+ * everything else and compiles the last into as few groups
+ * as possible.  This is done by match() the first time after
+ * a pattern is added, which isn't safe if other threads are
+ * matching at the same time, so call this before sharing the set.
+ */
+void GlobSet::compile()
+{
+    if (m_compiled)
+        return;
+    indexSuffixes();
+    m_groups.clear();
+    m_groupIndexes.clear();
+    m_negated.clear();
+
+    std::vector<size_t> others;
+    for (size_t i = 0; i < m_patterns.size(); ++i)
+    {
+        const std::string   &pattern = m_patterns[i];
+        if (isSuffix(pattern))
+            continue;
+        if (pattern.size() > 1 && pattern[0] == '^')
+            m_negated.push_back(std::make_pair(Glob(pattern), i));
+        else
+            others.push_back(i);
+    }
+    if (!others.empty())
+        pack(others);
+    m_compiled = true;
+}
+
+/**
+ * Adds patterns to a group until the table looks like it would
+ * be bigger than s_maxTable and then starts the next one, so
+ * each group is normally built just once.  A group's table has
+ * about as many rows as those of its patterns on their own, less
+ * one for each character a pattern starts with that another one
+ * does too, times the classes they split the bytes into between
+ * them, plus about half as much again for the sets of states the
+ * rows are built from.
+ *
+ * @param indexes Index in m_patterns of the patterns to compile
+ */
+void GlobSet::pack(const std::vector<size_t> &indexes)
+{
+    unsigned char   classes[256] = { 0 };
+    unsigned char   tried[256];
+    std::set<std::string_view>  packed;
+    size_t          rows = 0;
+    size_t          first = 0;
+    for (size_t i = 0; i < indexes.size(); ++i)
+    {
+        const std::string   &pattern = m_patterns[indexes[i]];
+        size_t  own = m_rows[indexes[i]];
+        size_t  more = own - std::min(shared(packed, pattern), own - 1);
+        std::copy(classes, classes + 256, tried);
+        unsigned    width = Glob::refine(pattern, tried);
+        if (i > first && (rows + more) * (width + width / 2) > s_maxTable)
+        {
+            group(indexes, first, i);
+            first = i;
+            rows = 0;
+            more = own;
+            packed.clear();
+            std::fill(tried, tried + 256, 0);
+            Glob::refine(pattern, tried);
+        }
+        rows += more;
+        packed.insert(pattern);
+        std::copy(tried, tried + 256, classes);
+    }
+    group(indexes, first, indexes.size());
+}
+
+/**
+ * Fills in m_suffixes and m_suffixLengths from the "*.ext"
+ * patterns.  The keys are views of the strings in m_patterns
+ * so this is redone whenever those are copied.
+ */
+void GlobSet::indexSuffixes()
+{
+    m_suffixes.clear();
+    m_suffixLengths.clear();
+    for (size_t i = 0; i < m_patterns.size(); ++i)
+    {
+        if (!isSuffix(m_patterns[i]))
+            continue;
+        std::string_view    suffix = std::string_view(m_patterns[i]).substr(1);
+        m_suffixes[suffix].push_back(i);
+        if (std::find(m_suffixLengths.begin(), m_suffixLengths.end(), suffix.size()) == m_suffixLengths.end())
+            m_suffixLengths.push_back(suffix.size());
+    }
+    std::sort(m_suffixLengths.begin(), m_suffixLengths.end());
+}
+
+/**
+ * Compiles them all together.  If pack() guessed wrong, because
+ * patterns with a '*' in the middle can make the states of each
+ * other's tables combine, and that is too big it splits them in
+ * half and tries again with each half.
+ *
+ * @param indexes Index in m_patterns of the patterns to compile
+ * @param first The first of indexes to compile
+ * @param last One past the last
+ */
+void GlobSet::group(const std::vector<size_t> &indexes, size_t first, size_t last)
+{
+    std::vector<std::string>    patterns;
+    for (size_t i = first; i < last; ++i)
+        patterns.push_back(m_patterns[indexes[i]]);
+    // A single pattern is always compiled
+    Glob    g(patterns, last - first > 1 ? s_maxTable : 0);
+    if (g.m_compiled.get())
+    {
+        m_groups.push_back(g);
+        m_groupIndexes.push_back(std::vector<size_t>(indexes.begin() + first, indexes.begin() + last));
+        return;
+    }
+    size_t  middle = first + (last - first) / 2;
+    group(indexes, first, middle);
+    group(indexes, middle, last);
+}
+
+/**
+ * Compiles the patterns if that hasn't been done since the
+ * last add().  Once they are, this only reads the set.
+ *
+ * @param word The word, usually a basename, to compare
+ * @return True if any pattern matches all of word
+ */
+bool GlobSet::match(std::string_view word)
+{
+    compile();
+    for (size_t i = 0; i < m_suffixLengths.size() && m_suffixLengths[i] <= word.size(); ++i)
+    {
+        if (m_suffixes.find(word.substr(word.size() - m_suffixLengths[i])) != m_suffixes.end())
+            return true;
+    }
+    for (size_t i = 0; i < m_groups.size(); ++i)
+    {
+        if (m_groups[i].match(word))
+            return true;
+    }
+    for (size_t i = 0; i < m_negated.size(); ++i)
+    {
+        if (m_negated[i].first.match(word))
+            return true;
+    }
+    return false;
+}
+
+/**
+ * The indexes are added in increasing order.  Like the other
+ * match() this compiles the patterns if needed.
+ *
+ * @param word The word, usually a basename, to compare
+ * @param which The index of each pattern that matches is added to this
+ * @return How many patterns matched
+ */
+size_t GlobSet::match(std::string_view word, std::vector<size_t> &which)
+{
+    compile();
+    size_t  start = which.size();
+    for (size_t i = 0; i < m_suffixLengths.size() && m_suffixLengths[i] <= word.size(); ++i)
+    {
+        HashMap<std::string_view, std::vector<size_t> >::const_iterator found =
+            m_suffixes.find(word.substr(word.size() - m_suffixLengths[i]));
+        if (found != m_suffixes.end())
+            which.insert(which.end(), found->second.begin(), found->second.end());
+    }
+    for (size_t i = 0; i < m_groups.size(); ++i)
+    {
+        size_t  first = which.size();
+        m_groups[i].matchAll(word, which);
+        // Indexes within the group to indexes of m_patterns
+        for (size_t j = first; j < which.size(); ++j)
+            which[j] = m_groupIndexes[i][which[j]];
+    }
+    for (size_t i = 0; i < m_negated.size(); ++i)
+    {
+        if (m_negated[i].first.match(word))
+            which.push_back(m_negated[i].second);
+    }
+    std::sort(which.begin() + start, which.end());
+    return which.size() - start;
+}
+}
@@ -144,7 +144,7 @@ Node * Node::create(const Path &path)
     {
         return new Node(path);
     }
-    catch (PathException)
+    catch (const PathException &)
     {
         return 0;
     }
@@ -6,8 +6,20 @@
 namespace path
 {
 NodeInfo::NodeInfo()
-    : m_size(0),
-      m_type(OTHER)
+    : m_fields(0),
+      m_size(0),
+      m_type(OTHER),
+      m_mode(0),
+      m_uid(0),
+      m_gid(0),
+      m_nlink(0),
+      m_inode(0),
+      m_dev(0),
+      m_blocks(0),
+      m_atime(),
+      m_mtime(),
+      m_ctime(),
+      m_btime()
 {
 }
 
@@ -15,8 +27,26 @@ NodeInfo::~NodeInfo()
 {
 }
 
+/**
+ * @return The NodeInfo::Field bits that have been set
+ */
+unsigned NodeInfo::fields() const
+{
+    return m_fields;
+}
+
+/**
+ * @param fields One or more NodeInfo::Field bits
+ * @return True if every one of them is valid
+ */
+bool NodeInfo::has(unsigned fields) const
+{
+    return (m_fields & fields) == fields;
+}
+
 NodeInfo &NodeInfo::setSize(off_t size)
 {
+    m_fields |= SIZE;
     m_size = size;
     return *this;
 }
@@ -28,6 +58,7 @@ off_t NodeInfo::size() const
 
 NodeInfo &NodeInfo::setType(NodeInfo::Type type)
 {
+    m_fields |= TYPE;
     m_type = type;
     return *this;
 }
@@ -46,4 +77,136 @@ bool NodeInfo::isDir() const
 {
     return m_type == NodeInfo::DIRECTORY;
 }
+
+NodeInfo &NodeInfo::setMode(mode_t mode)
+{
+    m_fields |= MODE;
+    m_mode = mode;
+    return *this;
+}
+
+mode_t NodeInfo::mode() const
+{
+    return m_mode;
+}
+
+NodeInfo &NodeInfo::setNlink(uint64_t nlink)
+{
+    m_fields |= NLINK;
+    m_nlink = nlink;
+    return *this;
+}
+
+uint64_t NodeInfo::nlink() const
+{
+    return m_nlink;
+}
+
+NodeInfo &NodeInfo::setUid(uid_t uid)
+{
+    m_fields |= UID;
+    m_uid = uid;
+    return *this;
+}
+
+uid_t NodeInfo::uid() const
+{
+    return m_uid;
+}
+
+NodeInfo &NodeInfo::setGid(gid_t gid)
+{
+    m_fields |= GID;
+    m_gid = gid;
+    return *this;
+}
+
+gid_t NodeInfo::gid() const
+{
+    return m_gid;
+}
+
+NodeInfo &NodeInfo::setAtime(const struct timespec &atime)
+{
+    m_fields |= ATIME;
+    m_atime = atime;
+    return *this;
+}
+
+const struct timespec &NodeInfo::atime() const
+{
+    return m_atime;
+}
+
+NodeInfo &NodeInfo::setMtime(const struct timespec &mtime)
+{
+    m_fields |= MTIME;
+    m_mtime = mtime;
+    return *this;
+}
+
+const struct timespec &NodeInfo::mtime() const
+{
+    return m_mtime;
+}
+
+NodeInfo &NodeInfo::setCtime(const struct timespec &ctime)
+{
+    m_fields |= CTIME;
+    m_ctime = ctime;
+    return *this;
+}
+
+const struct timespec &NodeInfo::ctime() const
+{
+    return m_ctime;
+}
+
+NodeInfo &NodeInfo::setBtime(const struct timespec &btime)
+{
+    m_fields |= BTIME;
+    m_btime = btime;
+    return *this;
+}
+
+const struct timespec &NodeInfo::btime() const
+{
+    return m_btime;
+}
+
+NodeInfo &NodeInfo::setInode(uint64_t inode)
+{
+    m_fields |= INODE;
+    m_inode = inode;
+    return *this;
+}
+
+uint64_t NodeInfo::inode() const
+{
+    return m_inode;
+}
+
+NodeInfo &NodeInfo::setDev(uint64_t dev)
+{
+    m_fields |= DEV;
+    m_dev = dev;
+    return *this;
+}
+
+uint64_t NodeInfo::dev() const
+{
+    return m_dev;
+}
+
+NodeInfo &NodeInfo::setBlocks(uint64_t blocks)
+{
+    m_fields |= BLOCKS;
+    m_blocks = blocks;
+    return *this;
+}
+
+uint64_t NodeInfo::blocks() const
+{
+    return m_blocks;
+}
 }
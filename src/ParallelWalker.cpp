@@ -0,0 +1,332 @@
+/**
+ * @file ParallelWalker.cpp
+ */
+#include <path/ParallelWalker.h>
+#include <path/WalkQueue.h>
+#include <path/DirEntries.h>
+#include <path/SysBase.h>
+#include <path/PathException.h>
+
+namespace path
+{
+/**
+ * @param threads How many threads to read directories with;
+ *                0 uses one per CPU
+ */
+ParallelWalker::ParallelWalker(unsigned threads)
+    : m_threads(threads ? threads : std::thread::hardware_concurrency()),
+      m_follow(false),
+      m_callback(),
+      m_queue(0),
+      m_workers(),
+      m_pending(0),
+      m_queued(0),
+      m_stop(false),
+      m_sleeping(0),
+      m_idleMutex(),
+      m_idle(),
+      m_error()
+{
+    if (m_threads == 0)
+        m_threads = 1;
+}
+
+/**
+ * Stops and waits for any walk that is still running.
+ * Exceptions from the callback are dropped.
+ */
+ParallelWalker::~ParallelWalker()
+{
+    if (m_workers.empty())
+        return;
+    stop();
+    try
+    {
+        wait();
+    }
+    catch (...)
+    {
+    }
+}
+
+unsigned ParallelWalker::threads() const
+{
+    return m_threads;
+}
+
+/**
+ * Following symbolic links can walk the same directory more
+ * than once or forever if a link points to its own parent.
+ *
+ * @param follow True to descend into links to directories
+ * @return A reference to this object
+ */
+ParallelWalker &ParallelWalker::setFollowLinks(bool follow)
+{
+    m_follow = follow;
+    return *this;
+}
+
+/**
+ * @param top The directory to walk
+ * @param callback Called from any of the threads for each entry
+ */
+void ParallelWalker::walk(const Path &top, const Callback &callback)
+{
+    start(top, callback);
+    wait();
+}
+
+/**
+ * Returns right away; use wait() to wait for the walk to end.
+ * Only one walk can run at a time.
+ *
+ * @param top The directory to walk
+ * @param callback Called from any of the threads for each entry
+ */
+void ParallelWalker::start(const Path &top, const Callback &callback)
+{
+    wait();
+    launch(top, callback);
+}
+
+/**
+ * The queue is closed when the walk ends so the consumer knows
+ * when to stop.  Closing the queue early stops the walk.
+ *
+ * @param top The directory to walk
+ * @param queue Where to put each entry
+ */
+void ParallelWalker::start(const Path &top, WalkQueue &queue)
+{
+    wait();
+    m_queue = &queue;
+    launch(top, [this, &queue](const Path &path, NodeInfo::Type type) {
+        if (!queue.push(path, type))
+            stop();
+    });
+}
+
+/**
+ * @param top The directory to walk
+ * @param callback Where entries go
+ */
+void ParallelWalker::launch(const Path &top, const Callback &callback)
+{
+    m_callback = callback;
+    m_stop = false;
+    m_error = std::exception_ptr();
+    m_pending = 0;
+    m_queued = 0;
+    m_sleeping = 0;
+    for (unsigned i = 0; i < m_threads; ++i)
+        m_workers.push_back(std::unique_ptr<Worker>(new Worker()));
+    push(0, top);
+    for (unsigned i = 0; i < m_threads; ++i)
+        m_workers[i]->m_thread = std::thread(&ParallelWalker::run, this, i);
+}
+
+/**
+ * Rethrows the first exception thrown by the callback.
+ */
+void ParallelWalker::wait()
+{
+    for (size_t i = 0; i < m_workers.size(); ++i)
+    {
+        if (m_workers[i]->m_thread.joinable())
+            m_workers[i]->m_thread.join();
+    }
+    m_workers.clear();
+    if (m_queue)
+    {
+        m_queue->close();
+        m_queue = 0;
+    }
+    m_callback = Callback();
+    if (m_error)
+    {
+        std::exception_ptr  error = m_error;
+        m_error = std::exception_ptr();
+        std::rethrow_exception(error);
+    }
+}
+
+/**
+ * Directories already being read are finished but no
+ * more are started.  A WalkQueue being filled is closed.
+ */
+void ParallelWalker::stop()
+{
+    m_stop = true;
+    if (m_queue)
+        m_queue->close();
+    std::lock_guard<std::mutex> lock(m_idleMutex);
+    m_idle.notify_all();
+}
+
+/**
+ * @param index Which thread this is
+ */
+void ParallelWalker::run(unsigned index)
+{
+    Path    dir;
+
+    for (;;)
+    {
+        if (take(index, dir))
+        {
+            if (!m_stop)
+            {
+                try
+                {
+                    readDir(index, dir);
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> lock(m_idleMutex);
+                    if (!m_error)
+                        m_error = std::current_exception();
+                    m_stop = true;
+                }
+            }
+            finished();
+            continue;
+        }
+
+        // Nothing to do; sleep until something is pushed or all is done
+        std::unique_lock<std::mutex> lock(m_idleMutex);
+        ++m_sleeping;
+        while (m_queued == 0 && m_pending != 0 && !m_stop)
+            m_idle.wait(lock);
+        --m_sleeping;
+        if (m_pending == 0 || (m_stop && m_queued == 0))
+            return;
+    }
+}
+
+/**
+ * Reports every entry in dir and queues its subdirectories
+ * on this thread's own deque.
+ *
+ * @param index Which thread this is
+ * @param dir The directory to read
+ */
+void ParallelWalker::readDir(unsigned index, const Path &dir)
+{
+    // One buffer per thread reused for every directory
+    thread_local DirEntries entries;
+
+    if (!System.readdir(dir.path(), entries))
+        return;
+    for (size_t i = 0; i < entries.size() && !m_stop; ++i)
+    {
+        DirEntry        entry = entries[i];
+        Path            child = dir / entry.name;
+        NodeInfo::Type  type = entry.type;
+
+        if (type == NodeInfo::UNKNOWN)
+        {
+            try
+            {
+                NodeInfo    *info = System.stat(child.path(), NodeInfo::TYPE, false);
+                type = info->type();
+                delete info;
+            }
+            catch (PathException &)
+            {
+                // Removed since it was listed
+                continue;
+            }
+        }
+        bool    subdir = type == NodeInfo::DIRECTORY;
+        if (type == NodeInfo::SYMLINK && m_follow)
+        {
+            try
+            {
+                subdir = child.isDir();
+            }
+            catch (PathException &)
+            {
+                // Dangling link
+            }
+        }
+        m_callback(child, type);
+        if (subdir)
+            push(index, child);
+    }
+}
+
+/**
+ * @param index Which worker's deque
+ * @param dir The directory to add
+ */
+void ParallelWalker::push(unsigned index, const Path &dir)
+{
+    // Count it first so it is never taken before it is counted
+    ++m_pending;
+    ++m_queued;
+    {
+        std::lock_guard<std::mutex> lock(m_workers[index]->m_mutex);
+        m_workers[index]->m_dirs.push_back(dir);
+    }
+    if (m_sleeping != 0)
+    {
+        std::lock_guard<std::mutex> lock(m_idleMutex);
+        m_idle.notify_one();
+    }
+}
+
+/**
+ * Takes the newest directory from our own deque, which is most
+ * likely still in cache, or else the oldest from another thread,
+ * which is most likely to have many subdirectories of its own.
+ *
+ * @param index Which thread this is
+ * @param dir Set to the directory to read
+ * @return false if there was nothing to take
+ */
+bool ParallelWalker::take(unsigned index, Path &dir)
+{
+    if (m_queued == 0)
+        return false;
+    {
+        Worker &self = *m_workers[index];
+        std::lock_guard<std::mutex> lock(self.m_mutex);
+        if (!self.m_dirs.empty())
+        {
+            dir = std::move(self.m_dirs.back());
+            self.m_dirs.pop_back();
+            --m_queued;
+            return true;
+        }
+    }
+    for (unsigned i = 1; i < m_threads; ++i)
+    {
+        Worker &victim = *m_workers[(index + i) % m_threads];
+        std::lock_guard<std::mutex> lock(victim.m_mutex);
+        if (!victim.m_dirs.empty())
+        {
+            dir = std::move(victim.m_dirs.front());
+            victim.m_dirs.pop_front();
+            --m_queued;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Wakes everyone up when the last directory is done and closes
+ * the WalkQueue so the consumer sees the end.
+ */
+void ParallelWalker::finished()
+{
+    if (--m_pending == 0)
+    {
+        if (m_queue)
+            m_queue->close();
+        std::lock_guard<std::mutex> lock(m_idleMutex);
+        m_idle.notify_all();
+    }
+}
+}
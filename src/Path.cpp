@@ -5,15 +5,40 @@
 #include <path/Canonical.h>
 #include <path/SysBase.h>
 #include <path/Strings.h>
-#include <path/Unimplemented.h>
 #include <path/NodeInfo.h>
 #include <path/PathIter.h>
 #include <path/PathExtra.h>
+#include <path/PathGlob.h>
+#include <path/PathException.h>
 
 #include <algorithm>
+#include <cerrno>
+#include <functional>
 #include <iostream>
 
 namespace path {
+/**
+ * Check if path() would be any different after path::expand()
+ *
+ * @param str The string to check
+ * @return True if str starts with '~' or has a '$'
+ */
+static bool needsExpand(const std::string &str)
+{
+    return (!str.empty() && str[0] == '~') || str.find('$') != std::string::npos;
+}
+
+/**
+ * str() and path() of a Path without any data, whatever its rules
+ *
+ * @return The empty string
+ */
+static const std::string &emptyString()
+{
+    static const std::string    empty;
+    return empty;
+}
+
 /**
  * Default set of rules if none are specified.  Also
  * see System::rules();
@@ -21,36 +46,62 @@ namespace path {
 RulesBase * Path::s_defaultRulesBase;
 
 /**
- * Initialize an empty Path
+ * Initialize an empty Path.  This doesn't allocate
+ * anything unless rules are given.
  *
  * @param rules Rules to initialize.  May be NULL.
  */
 Path::Path(const RulesBase *rules)
-    : m_meta(new PathExtra)
+    : m_meta()
 {
-    m_meta->m_rules = rules;
+    // Empty paths with the default rules share the same data
+    if (rules)
+    {
+        m_meta = new PathExtra;
+        m_meta->m_rules = rules;
+    }
 }
 
 /**
  * Initialize path, set rules to NULL (i.e. default)
  *
+ * The string is kept as is and returned by str().  It is only
+ * converted to a Canonical using rules() when canon() is first
+ * needed.
+ *
  * @param path The directory
  */
 Path::Path(const char *path)
     : m_meta(new PathExtra)
 {
-    m_meta->m_canon = new Canonical(path);
+    m_meta->m_path = new std::string(path);
 }
 
 /**
  * Initialize path, set rules to NULL (i.e. default)
  *
+ * The string is kept as is and returned by str().  It is only
+ * converted to a Canonical using rules() when canon() is first
+ * needed.
+ *
  * @param path The directory
  */
 Path::Path(const std::string &path)
     : m_meta(new PathExtra)
 {
-    m_meta->m_canon = new Canonical(path);
+    m_meta->m_path = new std::string(path);
+}
+
+/**
+ * Same as Path(const std::string &) but path is only
+ * copied once, into the new Path.
+ *
+ * @param path The directory
+ */
+Path::Path(std::string_view path)
+    : m_meta(new PathExtra)
+{
+    m_meta->m_path = new std::string(path);
 }
 
 /**
@@ -69,6 +120,20 @@ Path::Path(const Canonical &canon, const RulesBase *param_rules)
     m_meta->m_canon = new Canonical(canon);
 }
 
+/**
+ * Same as Path(const Canonical &, const RulesBase *) but
+ * takes over canon instead of copying it.
+ *
+ * @param canon Canonical version of path
+ * @param param_rules Rules to use
+ */
+Path::Path(Canonical &&canon, const RulesBase *param_rules)
+    : m_meta(new PathExtra)
+{
+    m_meta->m_rules = param_rules;
+    m_meta->m_canon = new Canonical(std::move(canon));
+}
+
 /**
  * Copy the m_path, make m_rules the same (pointer copy)
  * and duplicate the m_canon.
@@ -80,6 +145,27 @@ Path::Path(const Path &copy)
 {
 }
 
+/**
+ * Takes over the data from copy without changing any reference
+ * counts.  copy is left as an empty Path.
+ *
+ * @param copy Path to be moved
+ */
+Path::Path(Path &&copy) noexcept
+    : m_meta(std::move(copy.m_meta))
+{
+}
+
+/**
+ * Used internally to refer to the same data as another Path
+ *
+ * @param meta The shared data
+ */
+Path::Path(const Refcount<PathExtra> &meta)
+    : m_meta(meta)
+{
+}
+
 /**
  * Delete m_canon
  */
@@ -101,6 +187,18 @@ Path & Path::operator=(const Path &op)
     return  *this;
 }
 
+/**
+ * Takes over the data from op which is left as an empty Path.
+ *
+ * @param op The right hand side
+ * @return A reference to this path
+ */
+Path & Path::operator=(Path &&op) noexcept
+{
+    m_meta = std::move(op.m_meta);
+    return  *this;
+}
+
 /**
  * The unexpanded string is returned (no $VAR) expansion)
  *
@@ -118,9 +216,12 @@ Path & Path::operator=(const Path &op)
  */
 const std::string &Path::str() const
 {
-    if (!m_meta->m_path)
-        m_meta->m_path = new std::string(rules()->str(canon()));
-    return *m_meta->m_path;
+    if (!m_meta.get())
+        return emptyString();
+    std::string *str = meta()->m_path.load(std::memory_order_acquire);
+    if (!str)
+        str = PathExtra::publish(meta()->m_path, new std::string(rules()->str(canon())));
+    return *str;
 }
 
 /**
@@ -143,10 +244,22 @@ const char * Path::c_str() const
  */
 const std::string& Path::path() const
 {
-    if (m_meta->m_pathStr)
-        return *m_meta->m_pathStr;
-    m_meta->m_pathStr = new std::string(path::expand(rules()->str(canon()), System.env(), true));
-    return *m_meta->m_pathStr;
+    if (!m_meta.get())
+        return emptyString();
+    std::string *str = meta()->m_pathStr.load(std::memory_order_acquire);
+    if (str)
+        return *str;
+    // A Path made from a string is used as is unless it needs expanding
+    std::string *raw = meta()->m_path.load(std::memory_order_acquire);
+    if (raw && !meta()->m_canon.load(std::memory_order_acquire))
+    {
+        if (!needsExpand(*raw))
+            return *raw;
+        return *PathExtra::publish(meta()->m_pathStr,
+                                   new std::string(path::expand(*raw, System.env(), true)));
+    }
+    return *PathExtra::publish(meta()->m_pathStr,
+                               new std::string(path::expand(rules()->str(canon()), System.env(), true)));
 }
 
 /**
@@ -178,32 +291,33 @@ Path Path::expand() const
  */
 Path Path::expand(const StringMap &vars) const
 {
-    Strings     entries;    // Saves each directory component
-    const Strings &   comp = canon().components();
+    Canonical   entries(canon(), Strings()); // Saves each directory component
+    ComponentView comp = canon().view();
     bool        tilde = true;
 
-    for (Strings::const_iterator iter = comp.begin(); iter != comp.end(); ++iter)
+    for (ComponentView::const_iterator iter = comp.begin(); iter != comp.end(); ++iter)
     {
-        std::string p = path::expand(*iter, vars, tilde);
+        std::string orig(*iter);
+        std::string p = path::expand(orig, vars, tilde);
         tilde = false;
-        if (p == *iter)
+        if (p == orig)
         {
             // Nothing changed; just add it
-            entries.push_back(p);
+            entries.add(p);
         }
         else
         {
             // Convert the expanded variable into list of componenets
             // using the rules()
             Canonical   c(rules()->canonical(p));
-            Strings &   s = c.components();
-            std::copy(s.begin(), s.end(),
-                      std::back_insert_iterator<Strings>(entries));
+            ComponentView s = c.view();
+            for (ComponentView::const_iterator i = s.begin(); i != s.end(); ++i)
+                entries.add(*i);
         }
     }
     // Take the meta info from cannon(), the built up list
     // of components and our set of rules and return a path.
-    return Path(Canonical(canon(), entries), m_meta->m_rules);
+    return withCanon(std::move(entries));
 }
 
 /**
@@ -229,15 +343,18 @@ std::string Path::normpath() const
  */
 std::string Path::basename() const
 {
-    const Strings &components = canon().components();
+    if (meta()->m_parent.get())
+        return meta()->m_name;
 
-    if (components.size() == 0)
+    const Canonical &c = canon();
+
+    if (c.size() == 0)
     {
         return std::string();
     }
     else
     {
-        return components[components.size() - 1];
+        return std::string(c.component(c.size() - 1));
     }
 }
 
@@ -256,14 +373,12 @@ std::string Path::basename() const
  */
 Path Path::dirname() const
 {
-    Strings::const_iterator last;  // end elements
-    last = canon().components().end();
-    if (canon().components().size() > 0)
-        --last;
-    Strings com(canon().components().begin(), last);
+    if (meta()->m_parent.get())
+        return Path(meta()->m_parent);
 
-    Canonical  c(canon(), com);
-    return Path(c, m_meta->m_rules);
+    Canonical  c(canon());
+    c.removeLast();
+    return withCanon(std::move(c));
 }
 
 
@@ -333,7 +448,49 @@ Path Path::makeAbs() const
 {
     Canonical  c (canon());
     c.setAbs(true);
-    return Path(c, m_meta->m_rules);
+    return withCanon(std::move(c));
+}
+
+/**
+ * The returned Path is the same as this one but any Path created
+ * from it by add() (or operator/()) keeps a reference to it and the
+ * one additional component instead of a complete copy.  Those children
+ * also share with their children.  For example:
+ *
+ * @code
+ * Path root = Path(UnixPath("/usr/local")).makeShared();
+ * Path lib = root / "lib";        // constant time
+ * Path parent = lib.dirname();    // returns root; constant time
+ * @endcode
+ *
+ * This is most useful when creating many paths within
+ * a directory hierarchy, such as PathIter does.  A Path made from
+ * a string that hasn't been parsed yet stays that way until one of
+ * them needs canon().
+ *
+ * @return A new path whose children share it
+ */
+Path Path::makeShared() const
+{
+    std::string *raw = meta()->m_path.load(std::memory_order_acquire);
+    if (raw && !meta()->m_canon.load(std::memory_order_acquire) && !meta()->m_parent.get())
+    {
+        Path    p(*raw);
+        p.m_meta->m_rules = meta()->m_rules;
+        p.m_meta->m_shared = true;
+        return p;
+    }
+    Path    p(canon(), meta()->m_rules);
+    p.m_meta->m_shared = true;
+    return p;
+}
+
+/**
+ * @return True if children created with add() share this Path
+ */
+bool Path::shared() const
+{
+    return meta()->m_shared;
 }
 
 /**
@@ -386,11 +543,19 @@ Path Path::add(const Path &path) const
 {
     if (path.abs())
         return path;
+    if (meta()->m_shared)
+    {
+        Path p(*this);
+        ComponentView comp = path.canon().view();
+        for (ComponentView::const_iterator iter = comp.begin(); iter != comp.end(); ++iter)
+            p = p.child(std::string(*iter));
+        return p;
+    }
     Canonical c(canon());
-    std::copy(path.canon().components().begin(),
-              path.canon().components().end(),
-              std::back_inserter(c.components()));
-    return Path (c, m_meta->m_rules);
+    ComponentView comp = path.canon().view();
+    for (ComponentView::const_iterator iter = comp.begin(); iter != comp.end(); ++iter)
+        c.add(*iter);
+    return withCanon(std::move(c));
 }
 
 /**
@@ -412,11 +577,18 @@ Path Path::add(const Path &path) const
  */
 Path Path::add(const Strings &strings) const
 {
+    if (meta()->m_shared)
+    {
+        Path p(*this);
+        for (Strings::const_iterator iter = strings.begin(); iter != strings.end(); ++iter)
+            p = p.child(*iter);
+        return p;
+    }
 
     Canonical c(canon());
-    std::copy(strings.begin(), strings.end(),
-              std::back_inserter(c.components()));
-    return Path(c, m_meta->m_rules);
+    for (Strings::const_iterator iter = strings.begin(); iter != strings.end(); ++iter)
+        c.add(*iter);
+    return withCanon(std::move(c));
 }
 
 /**
@@ -427,9 +599,27 @@ Path Path::add(const Strings &strings) const
  */
 Path Path::add(const std::string &p) const
 {
+    if (meta()->m_shared)
+        return child(p);
     Canonical c(canon());
     c.add(p);
-    return Path(c, m_meta->m_rules);
+    return withCanon(std::move(c));
+}
+
+/**
+ * Same as add(const std::string &) but moves p
+ * into the new path instead of copying it.
+ *
+ * @param p Extra component to be added
+ * @return A new path with the same Canonical but one more element to components.
+ */
+Path Path::add(std::string &&p) const
+{
+    if (meta()->m_shared)
+        return child(std::move(p));
+    Canonical c(canon());
+    c.add(std::move(p));
+    return withCanon(std::move(c));
 }
 
 /**
@@ -438,7 +628,23 @@ Path Path::add(const std::string &p) const
  */
 Path Path::add(const char *p) const
 {
-    return add(std::string(p));
+    return add(std::string_view(p));
+}
+
+/**
+ * Add a single directory element without making a temporary
+ * std::string; the characters are copied once into the new Path.
+ *
+ * @param p Extra component to be added
+ * @return A new path with the same Canonical but one more element to components.
+ */
+Path Path::add(std::string_view p) const
+{
+    if (meta()->m_shared)
+        return child(std::string(p));
+    Canonical c(canon());
+    c.add(p);
+    return withCanon(std::move(c));
 }
 
 /**
@@ -456,12 +662,12 @@ std::vector<Path> Path::split() const
     Canonical              newcanon;
     std::vector<Path>       paths;
 
-    newcanon.setInfo(c).setAbs(c.abs());
-    for (Strings::const_iterator iter = c.components().begin();
-         iter != c.components().end(); ++iter)
+    newcanon.setInfo(c).setAbs(c.abs()).setPacked(c.packed());
+    ComponentView comp = c.view();
+    for (ComponentView::const_iterator iter = comp.begin(); iter != comp.end(); ++iter)
     {
         newcanon.add(*iter);
-        Path    p (newcanon, m_meta->m_rules);
+        Path    p (withCanon(newcanon));
         paths.push_back(p);
     }
     return paths;
@@ -475,9 +681,129 @@ std::vector<Path> Path::split() const
  */
 const Canonical & Path::canon() const
 {
-    if (!m_meta->m_canon)
-        m_meta->m_canon = new Canonical();
-    return *m_meta->m_canon;
+    static const Canonical  empty;
+    if (!m_meta.get())
+        return empty;
+    Canonical *canon = meta()->m_canon.load(std::memory_order_acquire);
+    if (canon)
+        return *canon;
+    if (!meta()->m_parent.get())
+    {
+        // Parse the string this Path was created from
+        std::string *str = meta()->m_path.load(std::memory_order_acquire);
+        if (str)
+            return *PathExtra::publish(meta()->m_canon, new Canonical(rules()->canonical(*str)));
+        return *PathExtra::publish(meta()->m_canon, new Canonical());
+    }
+
+    // Walk up to the first parent with a Canonical
+    // without building one for each parent.
+    std::vector<const std::string *>    names;
+    PathExtra *extra = meta();
+    const Canonical *base = 0;
+    while (!(base = extra->m_canon.load(std::memory_order_acquire)) && extra->m_parent.get())
+    {
+        names.push_back(&extra->m_name);
+        if (!extra->m_parent.get()->m_parent.get()
+            && !extra->m_parent.get()->m_canon.load(std::memory_order_acquire))
+        {
+            // The root hasn't been parsed yet; it keeps what it parses
+            base = &Path(extra->m_parent).canon();
+            break;
+        }
+        extra = extra->m_parent.get();
+    }
+    Canonical *c = new Canonical(*base);
+    for (std::vector<const std::string *>::reverse_iterator iter = names.rbegin();
+         iter != names.rend(); ++iter)
+        c->add(**iter);
+    return *PathExtra::publish(meta()->m_canon, c);
+}
+
+/**
+ * The hash is calculated from canon() the first time it
+ * is needed and then saved with the Path so copies share it.
+ * The rules are not part of the hash.  Paths that
+ * compare equal (see operator==()) have the same hash.
+ *
+ * @return The hash value
+ */
+size_t Path::hash() const
+{
+    size_t  h = meta()->m_hash.load(std::memory_order_relaxed);
+    if (h)
+        return h;
+    h = canon().hash();
+    if (!h)
+        h = 1;          // 0 means not calculated yet
+    if (m_meta.get())
+        m_meta.get()->m_hash.store(h, std::memory_order_relaxed);
+    return h;
+}
+
+/**
+ * Create a path with the same rules as this one.  If this
+ * path is shared(), the new one is, too.
+ *
+ * @param c The Canonical for the new Path
+ * @return The new Path
+ */
+Path Path::withCanon(const Canonical &c) const
+{
+    Path    p(c, meta()->m_rules);
+    p.m_meta->m_shared = meta()->m_shared;
+    return p;
+}
+
+/**
+ * Same as withCanon(const Canonical &) but takes over c.
+ *
+ * @param c The Canonical for the new Path
+ * @return The new Path
+ */
+Path Path::withCanon(Canonical &&c) const
+{
+    Path    p(std::move(c), meta()->m_rules);
+    p.m_meta->m_shared = meta()->m_shared;
+    return p;
+}
+
+/**
+ * A default constructed (or moved from) Path doesn't
+ * have any data of its own and shares an empty PathExtra.
+ * Nothing is ever cached in that one; str(), canon() and the
+ * rest check m_meta first so an empty Path doesn't depend on
+ * what another empty Path was asked before.
+ *
+ * @return The data for this Path; never NULL
+ */
+PathExtra *Path::meta() const
+{
+    PathExtra   *extra = m_meta.get();
+    if (extra)
+        return extra;
+    static PathExtra    empty;
+    return &empty;
+}
+
+/**
+ * Create a new path that only stores a reference
+ * to this path and the additional component.  An empty
+ * name is ignored the same as Canonical::add().
+ *
+ * @param name The last component of the new path
+ * @return The new Path
+ */
+Path Path::child(std::string name) const
+{
+    if (name.empty())
+        return *this;
+    Path    p(Refcount<PathExtra>(new PathExtra));
+    p.m_meta->m_rules = meta()->m_rules;
+    p.m_meta->m_parent = m_meta;
+    p.m_meta->m_name = std::move(name);
+    p.m_meta->m_shared = true;
+    return p;
 }
 
 /**
@@ -486,7 +812,7 @@ const Canonical & Path::canon() const
  */
 const RulesBase *Path::pathRules() const
 {
-    return m_meta->m_rules;
+    return meta()->m_rules;
 }
 
 /**
@@ -499,8 +825,8 @@ const RulesBase *Path::pathRules() const
  */
 const RulesBase *Path::rules() const
 {
-    if (m_meta->m_rules)
-        return m_meta->m_rules;
+    if (meta()->m_rules)
+        return meta()->m_rules;
     else
         return defaultRulesBase();
 }
@@ -575,28 +901,33 @@ Path::const_iterator Path::end() const
 }
 
 /**
- * Use shell pattern expansion to list contents of a directory.
- * Returns an iterator to the list.  Note that this only works within
- * the specied directory that this Path already represents.
+ * Use shell pattern expansion to find what is in this directory.
+ * The pattern can have several components separated by '/', each
+ * of which can be a shell pattern, and "**" for any number of
+ * directories (see PathGlob).  Only the directories the pattern
+ * can match are read.  The matches are found before this returns
+ * and the iterator goes through them in order.
  *
- * Not yet implemented
- * ;;; TODO: Implement glob()
- *
- * @param pattern A shell pattern ("*.C", "*", *.[Cho]")
+ * @param pattern A shell pattern ("*.C", "*", "*.[Cho]", "src/[a-m]*.h", "**")
+ * @return An iterator through the matches
  */
 Path::iterator Path::glob(const std::string & pattern)
 {
-    throw Unimplemented("Path::glob");
-    return  PathIter();
+    return static_cast<const Path &>(*this).glob(pattern);
 }
 
 /**
- * @param pattern A shell pattern ("*.C", "*", *.[Cho]")
+ * @param pattern A shell pattern ("*.C", "*", "*.[Cho]", "src/[a-m]*.h", "**")
+ * @return An iterator through the matches
  */
 Path::const_iterator Path::glob(const std::string & pattern) const
 {
-    throw Unimplemented("Path::glob");
-    return  PathIter();
+    Paths       found;
+    PathGlob(*this, pattern).find(found);
+    PathIter    iter;
+    for (Paths::const_iterator p = found.begin(); p != found.end(); ++p)
+        iter.addPath(*p);
+    return iter;
 }
 
 /**
@@ -608,9 +939,76 @@ Path::const_iterator Path::glob(const std::string & pattern) const
  */
 const NodeInfo & Path::info() const
 {
-    if (!m_meta->m_cache)
-        m_meta->m_cache = System.stat(path());
-    return *m_meta->m_cache;
+    if (!m_meta.get())
+        throw PathException(emptyString(), ENOENT);
+    NodeInfo *info = meta()->m_cache.load(std::memory_order_acquire);
+    if (!info)
+        info = PathExtra::publish(meta()->m_cache, System.stat(path()));
+    return *info;
+}
+
+/**
+ * Avoids calling System.stat() if what was found out when listing
+ * the directory holding this path (see PathIter) is enough.
+ * Otherwise only fields are asked for, so a file system that can
+ * skip the rest (see SysBase::stat()) does less work.
+ *
+ * What was found out is kept for the next call if it has all of
+ * fields.  Only the first such NodeInfo is kept; a later call it
+ * doesn't cover falls back to info().
+ *
+ * @code
+ * if (iter->info(NodeInfo::TYPE).isDir())
+ * @endcode
+ *
+ * @throws PathException
+ * @param fields The NodeInfo::Field bits needed
+ * @return NodeInfo about this path with at least those fields,
+ *      unless the file system can't provide them
+ */
+const NodeInfo & Path::info(unsigned fields) const
+{
+    if (!m_meta.get() || (fields & NodeInfo::ALL) == NodeInfo::ALL)
+        return this->info();
+    PathExtra   *extra = meta();
+    NodeInfo    *info = extra->m_cache.load(std::memory_order_acquire);
+    if (info)
+        return *info;
+    if (extra->m_type != NodeInfo::UNKNOWN)
+    {
+        unsigned    listed = NodeInfo::TYPE;
+        if (extra->m_inode != 0)
+            listed |= NodeInfo::INODE;
+        if ((fields & ~listed) == 0)
+        {
+            info = extra->m_listed.load(std::memory_order_acquire);
+            if (!info)
+            {
+                info = new NodeInfo;
+                info->setType(extra->m_type);
+                if (extra->m_inode != 0)
+                    info->setInode(extra->m_inode);
+                info = PathExtra::publish(extra->m_listed, info);
+            }
+            return *info;
+        }
+    }
+    info = extra->m_partial.load(std::memory_order_acquire);
+    if (info && info->has(fields))
+        return *info;
+    if (!info)
+    {
+        info = System.stat(path(), fields);
+        if (info->has(fields))
+        {
+            info = PathExtra::publish(extra->m_partial, info);
+            if (info->has(fields))
+                return *info;
+        }
+        else
+            delete info;
+    }
+    return this->info();
 }
 
 bool Path::exists() const
@@ -631,12 +1029,35 @@ off_t Path::size() const
 /**
  * Returns if path represents a directory.
  * Throws PathException if not able to access path.
+ * Paths from a PathIter usually know this already.
  */
 bool Path::isDir() const
 {
+    PathExtra   *extra = meta();
+    if (extra->m_type != NodeInfo::UNKNOWN && !extra->m_cache.load(std::memory_order_acquire))
+        return extra->m_type == NodeInfo::DIRECTORY;
     return info().isDir();
 }
 
+/**
+ * Used by PathIter so the type (and maybe the inode) from
+ * reading the directory can be used by isDir() and
+ * info(unsigned).  Nothing is allocated until they are asked
+ * for.  Only call this on a Path that was just created and
+ * hasn't been copied.
+ *
+ * @param type The type readdir() found
+ * @param inode The inode number or 0
+ */
+void Path::listed(NodeInfo::Type type, uint64_t inode)
+{
+    PathExtra   *extra = m_meta.get();
+    if (!extra)
+        return;
+    extra->m_type = type;
+    extra->m_inode = inode;
+}
+
 /**
  * Return the current working directory as an absolute path.
  */
@@ -689,6 +1110,28 @@ void Path::mkfile(const Path &path, int dirmode, int filemode)
     System.touch(path.path(), filemode);
 }
 
+/**
+ * @param path The Path to compare with
+ * @return true if this and path were returned by PathTable::intern() for the same table
+ */
+bool Path::sameTable(const Path &path) const
+{
+    const PathTable *table = meta()->m_table.load(std::memory_order_relaxed);
+    return table && table == path.meta()->m_table.load(std::memory_order_relaxed);
+}
+
+/**
+ * Only meaningful if sameTable() is true.
+ *
+ * @param path The Path to compare with
+ * @return true if this and path have the same id in their PathTable
+ */
+bool Path::sameInterned(const Path &path) const
+{
+    return meta()->m_id.load(std::memory_order_relaxed)
+        == path.meta()->m_id.load(std::memory_order_relaxed);
+}
+
 /**
  * This is useful for things like adding a version
  * number or a backup of a file.  For example:
@@ -708,18 +1151,23 @@ void Path::mkfile(const Path &path, int dirmode, int filemode)
  * @param append String to be added
  * @return A new Path with the same rules.
  */
-Path Path::operator+(const std::string &append) const
+Path Path::operator+(std::string_view append) const
 {
+    if (meta()->m_parent.get())
+    {
+        std::string name;
+        name.reserve(meta()->m_name.size() + append.size());
+        name.append(meta()->m_name).append(append);
+        return Path(meta()->m_parent).child(std::move(name));
+    }
+
     Canonical c(canon());
 
-    if (c.components().size() > 0)
-        c.components()[c.components().size() - 1] += append;
-    else
-        c.components().push_back(append);
-    return Path(c, m_meta->m_rules);
+    c.extendLast(append);
+    return withCanon(std::move(c));
 }
 
-struct ConvertToPath : public std::unary_function<std::string, Path>
+struct ConvertToPath
 {
     const RulesBase *m_rules;
     ConvertToPath(const RulesBase *rules)
@@ -759,8 +1207,6 @@ Paths strings2Paths(const Strings &strings, const RulesBase *rules)
     return paths;
 }
 
-}
-
 /**
  * Compares the RulesBase and Canonical componenets
  * to see if they are the same.  So while two paths
@@ -768,17 +1214,47 @@ Paths strings2Paths(const Strings &strings, const RulesBase *rules)
  * the same, they will not compare equally.  See
  * normpath() as a way to make them compare the same
  *
+ * Paths interned in the same PathTable only compare their ids.
+ *
  * @param op1 The first argument to ==
  * @param op2 The second argument to ==
  * @return True if the same, false otherwise.
  */
 bool operator==(const path::Path &op1, const path::Path & op2)
 {
+    // Interned paths are the same only if they have the same id
+    if (op1.sameTable(op2))
+        return op1.sameInterned(op2);
     bool r = (op1.rules() == op2.rules());
     bool c = (op1.canon() == op2.canon());
     return r && c;
 }
 
+/**
+ * Orders Paths so they can be sorted or used as keys
+ * in a std::map.  Paths are ordered by hash() first so
+ * most comparisons don't need to look at the components.
+ * If the hashes are the same, the RulesBase pointers and then
+ * the Canonical values are compared.  This means the order
+ * is not alphabetical but it is consistent with operator==().
+ *
+ * @param op1 Left hand side
+ * @param op2 Right hand side
+ * @return True if op1 comes before op2
+ */
+bool operator<(const path::Path &op1, const path::Path &op2)
+{
+    if (op1.sameTable(op2) && op1.sameInterned(op2))
+        return false;
+    size_t  h1 = op1.hash();
+    size_t  h2 = op2.hash();
+    if (h1 != h2)
+        return h1 < h2;
+    if (op1.rules() != op2.rules())
+        return std::less<const path::RulesBase *>()(op1.rules(), op2.rules());
+    return op1.canon() < op2.canon();
+}
+
 /**
  * Inverse of operator==()
  *
@@ -819,8 +1295,7 @@ std::ostream &operator<<(std::ostream &out, const path::Path&path)
  */
 path::Path operator/(const path::Path &path, const char *dir)
 {
-    return path.add(std::string(dir));
-
+    return path.add(std::string_view(dir));
 }
 
 /**
@@ -836,6 +1311,32 @@ path::Path operator/(const path::Path &path, const std::string &dir)
 
 }
 
+/**
+ * Add another component to path and return a new Path
+ *
+ * @param path The path to add to
+ * @param dir The directory to add to path; it is moved
+ * @return A new Path
+ */
+path::Path operator/(const path::Path &path, std::string &&dir)
+{
+    return path.add(std::move(dir));
+}
+
+/**
+ * Add another component to path and return a new Path
+ *
+ * The characters in dir are only copied once, into the new Path.
+ *
+ * @param path The path to add to
+ * @param dir The directory to add to path
+ * @return A new Path
+ */
+path::Path operator/(const path::Path &path, std::string_view dir)
+{
+    return path.add(dir);
+}
+
 /**
  * Add another component to path and return a new Path
  *
@@ -847,3 +1348,4 @@ path::Path operator/(const path::Path &path, const path::Path &op2)
 {
     return path.add(op2);
 }
+}
@@ -11,15 +11,27 @@ PathExtra::PathExtra()
       m_rules(0),
       m_canon(0),
       m_pathStr(0),
-      m_cache(0)
+      m_cache(0),
+      m_listed(0),
+      m_partial(0),
+      m_type(NodeInfo::UNKNOWN),
+      m_inode(0),
+      m_hash(0),
+      m_parent(),
+      m_name(),
+      m_shared(false),
+      m_table(0),
+      m_id(0)
 {
 }
 
 PathExtra::~PathExtra(void)
 {
-    delete m_path;
-    delete m_canon;
-    delete m_pathStr;
-    delete m_cache;
+    delete m_path.load();
+    delete m_canon.load();
+    delete m_pathStr.load();
+    delete m_cache.load();
+    delete m_listed.load();
+    delete m_partial.load();
 }
 }
@@ -0,0 +1,210 @@
+/**
+ * @file PathGlob.cpp
+ */
+#include <path/PathGlob.h>
+#include <path/SysBase.h>
+#include <path/PathException.h>
+
+#include <memory>
+
+namespace path {
+/**
+ * @param name One component of the pattern
+ */
+PathGlob::Component::Component(const std::string &name)
+    : m_kind(NAME),
+      m_name(name),
+      m_glob(std::string()),
+      m_hidden(!name.empty() && name[0] == '.')
+{
+    if (name == "**")
+        m_kind = ANY;
+    else if (name.find_first_of("*?[{\\") != std::string::npos)
+    {
+        m_kind = PATTERN;
+        m_glob = Glob(name);
+    }
+}
+
+/**
+ * A pattern starting with '/' starts at the root instead of dir.
+ * Empty components and "**" right after another are left out.
+ *
+ * @param dir The directory the pattern is relative to
+ * @param pattern Components separated by '/'
+ */
+PathGlob::PathGlob(const Path &dir, const std::string &pattern)
+    : m_dir(dir),
+      m_components()
+{
+    if (!pattern.empty() && pattern[0] == '/')
+        m_dir = Path("/");
+    size_t  start = 0;
+    while (start <= pattern.size())
+    {
+        size_t  end = pattern.find('/', start);
+        if (end == std::string::npos)
+            end = pattern.size();
+        std::string name = pattern.substr(start, end - start);
+        start = end + 1;
+        if (name.empty())
+            continue;
+        if (name == "**" && !m_components.empty() && m_components.back().m_kind == ANY)
+            continue;
+        m_components.push_back(Component(name));
+    }
+}
+
+PathGlob::~PathGlob()
+{
+}
+
+/**
+ * Nothing is found if the pattern is empty.
+ *
+ * @param found Each match is added to this
+ */
+void PathGlob::find(Paths &found) const
+{
+    if (!m_components.empty())
+        walk(m_dir, 0, found);
+}
+
+/**
+ * Names are added to dir without looking at the file system
+ * until the last component or one that needs dir to be read.
+ * A directory that doesn't exist just reads as empty.
+ *
+ * @param dir The directory components index onwards are in
+ * @param index The component to match in dir
+ * @param found Each match is added to this
+ */
+void PathGlob::walk(const Path &dir, size_t index, Paths &found) const
+{
+    Path    path(dir);
+    for (; index < m_components.size() && m_components[index].m_kind == NAME; ++index)
+        path = path / m_components[index].m_name;
+    if (index == m_components.size())
+    {
+        if (System.exists(path.path()))
+            found.push_back(path);
+        return;
+    }
+    DirEntries          listing;
+    std::vector<size_t> order;
+    if (read(path, listing, order))
+        entries(path, listing, order, index, found);
+}
+
+/**
+ * The listing of dir is used for both a "**" and the component
+ * after it, so a name after "**" doesn't need exists().  The type
+ * from readdir() says which entries are directories.  One that
+ * isn't known is assumed to be one for a pattern, as reading it
+ * fails if it isn't, but "**" checks without following links.
+ *
+ * @param dir The directory that was read
+ * @param listing Everything in dir
+ * @param order The order to go through listing
+ * @param index The component to match in dir
+ * @param found Each match is added to this
+ */
+void PathGlob::entries(const Path &dir, const DirEntries &listing,
+                       const std::vector<size_t> &order, size_t index, Paths &found) const
+{
+    const Component &c = m_components[index];
+    size_t  last = m_components.size() - 1;
+    if (c.m_kind == ANY)
+    {
+        // No directories at all; a name is looked for in listing
+        const Component *next = index < last ? &m_components[index + 1] : 0;
+        if (next && next->m_kind == PATTERN)
+            entries(dir, listing, order, index + 1, found);
+        for (size_t i = 0; next && next->m_kind == NAME && i < order.size(); ++i)
+        {
+            DirEntry    entry = listing[order[i]];
+            if (entry.name != next->m_name)
+                continue;
+            if (index + 1 == last)
+                found.push_back(child(dir, entry));
+            else if (entry.type != NodeInfo::FILE && entry.type != NodeInfo::DEVICE
+                     && entry.type != NodeInfo::OTHER)
+                walk(child(dir, entry), index + 2, found);
+            break;
+        }
+        for (size_t i = 0; i < order.size(); ++i)
+        {
+            DirEntry    entry = listing[order[i]];
+            if (entry.name[0] == '.')
+                continue;
+            // Only real directories so a link can't make a loop
+            bool    subdir = entry.type == NodeInfo::DIRECTORY;
+            if (index != last && entry.type != NodeInfo::DIRECTORY && entry.type != NodeInfo::UNKNOWN)
+                continue;
+            Path    path = child(dir, entry);
+            if (index == last)
+                found.push_back(path);
+            if (entry.type == NodeInfo::UNKNOWN)
+            {
+                std::unique_ptr<NodeInfo>   info;
+                try
+                {
+                    info.reset(System.stat(path.path(), NodeInfo::TYPE, false));
+                }
+                catch (const PathException &)
+                {
+                }
+                subdir = info && info->isDir();
+            }
+            if (!subdir)
+                continue;
+            DirEntries          below;
+            std::vector<size_t> belowOrder;
+            if (read(path, below, belowOrder))
+                entries(path, below, belowOrder, index, found);
+        }
+        return;
+    }
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        DirEntry    entry = listing[order[i]];
+        if ((entry.name[0] == '.' && !c.m_hidden) || !c.m_glob.match(entry.name))
+            continue;
+        if (index == last)
+            found.push_back(child(dir, entry));
+        else if (entry.type != NodeInfo::FILE && entry.type != NodeInfo::DEVICE
+                 && entry.type != NodeInfo::OTHER)
+            walk(child(dir, entry), index + 1, found);
+    }
+}
+
+/**
+ * @param dir The directory to read
+ * @param listing Replaced with the contents of dir
+ * @param order Replaced with the BYTEWISE order of listing
+ * @return false if dir couldn't be read
+ */
+bool PathGlob::read(const Path &dir, DirEntries &listing, std::vector<size_t> &order)
+{
+    if (!System.readdir(dir.path(), listing))
+        return false;
+    listing.sort(order, DirEntries::BYTEWISE);
+    return true;
+}
+
+/**
+ * Like PathIter, the type is kept unless it is a symbolic link
+ * and the inode unless it is a directory.
+ *
+ * @param dir The directory that was read
+ * @param entry What was read for the child
+ * @return dir / entry.name
+ */
+Path PathGlob::child(const Path &dir, const DirEntry &entry)
+{
+    Path    path = dir / entry.name;
+    if (entry.type != NodeInfo::UNKNOWN && entry.type != NodeInfo::SYMLINK)
+        path.listed(entry.type, entry.type == NodeInfo::DIRECTORY ? 0 : entry.inode);
+    return path;
+}
+}
@@ -4,37 +4,167 @@
 #include <path/PathIter.h>
 #include <path/Node.h>
 #include <path/SysBase.h>
+#include <path/PathBadException.h>
+#include <path/PathPermissionException.h>
+#include <path/DirEntries.h>
+#include <path/Glob.h>
 
 #include <iterator>
 #include <algorithm>
+#include <deque>
+#include <limits>
+#include <regex>
+#include <vector>
 
 namespace path {
+/**
+ * Everything a PathIter needs to carry on iterating.  Copies of
+ * a PathIter share one State until one of them changes it.
+ *
+ * Going depth first, there is one Cursor per directory level
+ * between the starting Node and the current entry.  Going breadth
+ * first, there is only ever one Cursor and subdirectories wait in
+ * m_frontier until it is finished.  Only the entry being visited,
+ * or a directory being read, is made into a Path.
+ */
+struct PathIter::State : public RefcountBase
+{
+    /// The pattern given to the constructor, compiled once and shared
+    struct Matcher : public RefcountBase
+    {
+        bool        m_regexp;   ///< Use m_regex instead of m_glob
+        Glob        m_glob;     ///< The shell pattern
+        std::regex  m_regex;    ///< The regular expression
+
+        /// Compile pattern
+        Matcher(const std::string &pattern, bool regexp);
+        /// Return true if name matches
+        bool match(std::string_view name) const;
+    };
+
+    /// One directory being iterated through
+    struct Cursor
+    {
+        Path                m_dir;      ///< The directory that was read
+        DirEntries          m_entries;  ///< Its contents
+        std::vector<size_t> m_order;    ///< Order to visit m_entries
+        Paths               m_extra;    ///< From addPath(), visited after m_entries
+        size_t              m_index;    ///< Entry being visited
+        size_t              m_level;    ///< Levels below the starting Node
+        DirEntries::SortOrder m_sorted; ///< How m_order was sorted
+        int                 m_fd;       ///< Kept open for setRelative() or -1
+
+        /// Return the number of entries
+        size_t size() const;
+        /// Return the name of entry index or null for m_extra
+        const char *name(size_t index) const;
+        /// Return the type of entry index if known
+        NodeInfo::Type type(size_t index) const;
+    };
+
+    /// Nothing to iterate through
+    State(const Path *parent);
+    /// Copy the Cursors without the open directories
+    State(const State &copy);
+    /// Closes any directories still open
+    ~State();
+
+    /// Read dir into a new Cursor on top of the stack
+    void        push(const Path &dir, const char *name, int dirfd, size_t level);
+    /// Remove the top Cursor
+    void        pop();
+    /// Move to the next entry
+    void        advance();
+    /// Go into the entry being visited or past it; settle() finds the next
+    void        step();
+    /// Set m_path to the entry being visited, popping finished Cursors
+    void        settle();
+    /// Pass what readdir() found out on to m_path
+    void        listed(const DirEntry &entry);
+    /// Fill in the order to visit c's entries
+    void        order(Cursor &c) const;
+    /// Return how to sort each directory
+    DirEntries::SortOrder sortOrder() const;
+    /// Sort the starting directory again if nothing in it was visited
+    void        reorder();
+    /// Return if the entry being visited should be read
+    bool        descend() const;
+    /// Return if the entry being visited is a directory
+    bool        isDir() const;
+    /// Add path to be visited after everything else
+    void        addPath(const Path &path);
+    /// Open the current directory for setRelative()
+    void        setRelative();
+
+    /// Actual Node being iterated over
+    const Path *m_parent;
+    /// One Cursor per level; only the first m_depth are in use
+    std::vector<Cursor> m_stack;
+    /// Number of Cursors in use; 0 is the end()
+    size_t      m_depth;
+    /// The entry being visited
+    Path        m_path;
+    /// Traverse subdirectories, too
+    bool        m_recursive;
+    /// How to traverse them
+    TraversalOrder m_traversal;
+    /// How to sort each directory unless IN_ORDER
+    DirEntries::SortOrder m_sort;
+    /// Subdirectories found going breadth first but not yet read and their level
+    std::deque<std::pair<Path, size_t> > m_frontier;
+    /// Don't descend into the entry being visited
+    bool        m_pruned;
+    /// Only descend into directories this accepts, if set
+    DirFilter   m_filter;
+    /// Deepest level to read
+    size_t      m_maxDepth;
+    /// Open subdirectories relative to their parent
+    bool        m_relative;
+    /// Only visit entries whose name matches, if set
+    Refcount<Matcher> m_match;
+    /// advance() has been called
+    bool        m_started;
+    /// Most directories kept open at once
+    static const size_t s_maxOpen;
+
+private:
+    /// Not assignable
+    State &operator=(const State &op2);
+};
+
+/**
+ * Most directories setRelative() keeps open at once.  Deeper
+ * than this, subdirectories are opened by their full path.
+ */
+const size_t PathIter::State::s_maxOpen = 64;
+
 /**
  * Create a default iterator.  This corresponds to the
  * end() iterator.
  */
 PathIter::PathIter()
-    : m_parent(0),
-      m_nodeList(),
-      m_current(-1),
-      m_recursive(false)
+    : m_state()
 {
 }
 
 /**
+ * Shares the state with copy so this doesn't copy anything.
+ *
  * @param copy The PathIter to copy
  */
 PathIter::PathIter(const PathIter &copy)
-    : m_parent(copy.m_parent),
-      m_nodeList(),
-      m_current(copy.m_current),
-      m_recursive(copy.m_recursive)
+    : m_state(copy.m_state)
+{
+}
+
+/**
+ * copy is left as the end() iterator.
+ *
+ * @param copy The PathIter to move
+ */
+PathIter::PathIter(PathIter &&copy) noexcept
+    : m_state(std::move(copy.m_state))
 {
-    for (std::vector<Path *>::const_iterator iter = copy.m_nodeList.begin();
-         iter != copy.m_nodeList.end(); ++iter)
-    {
-        m_nodeList.push_back(new Path(**iter));
-    }
 }
 
 /**
@@ -43,45 +173,41 @@ PathIter::PathIter(const PathIter &copy)
  * @param node The Node this is going to iterate through
  */
 PathIter::PathIter(const Path &node)
-    : m_parent(&node),
-      m_nodeList(),
-      m_current(0),
-      m_recursive(false)
+    : m_state(new State(&node))
 {
-    addNodes(m_parent);
-    if (size() == 0)
-        m_current = -1;
+    m_state->push(node, 0, -1, 0);
+    m_state->settle();
 }
 
 /**
- * Makes iterator return all Nodes within a directory.
+ * Makes iterator return the Nodes within a directory whose
+ * name matches pattern.  The pattern is compiled once and each
+ * name is compared as it is read, so nothing else is done for an
+ * entry that doesn't match; it isn't even made into a Path.  With
+ * setRecursive(), directories that don't match are still read.
  *
- * Not yet implemented, just iterates through all
+ * A shell pattern is a Glob that must match the whole name.  A
+ * regular expression (ECMAScript, like std::regex) matches if it
+ * is found anywhere in the name so use '^' and '$' to anchor it.
  *
+ * @throws std::regex_error if regexp is true and pattern is invalid
  * @param node The Node this is going to interate through
  * @param pattern Pattern to match (shell or regular expression)
  * @param regexp This is a regular expression, not a shell pattern
  */
 PathIter::PathIter(const Path &node, const std::string & pattern, bool regexp)
-    : m_parent(&node),
-      m_nodeList(),
-      m_current(0),
-      m_recursive(false)
+    : m_state(new State(&node))
 {
-    addNodes(m_parent);
-    if (size() == 0)
-        m_current = -1;
+    m_state->m_match = Refcount<State::Matcher>(new State::Matcher(pattern, regexp));
+    m_state->push(node, 0, -1, 0);
+    m_state->settle();
 }
 
 /**
- * Delete all items in m_nodeList
+ * The last copy closes any directories still open
  */
 PathIter::~PathIter()
 {
-    for(std::vector<Path *>::iterator iter = m_nodeList.begin();
-        iter != m_nodeList.end(); ++iter)
-        delete *iter;
-    m_nodeList.clear();
 }
 
 /**
@@ -90,20 +216,19 @@ PathIter::~PathIter()
  */
 PathIter &PathIter::operator=(const PathIter &op2)
 {
-    if (this == &op2)
-        return *this;
-    m_parent = op2.m_parent;
-    m_current = op2.m_current;
-    for(std::vector<Path *>::iterator iter = m_nodeList.begin();
-        iter != m_nodeList.end(); ++iter)
-        delete *iter;
-    m_nodeList.clear();
-    for (std::vector<Path *>::const_iterator iter = op2.m_nodeList.begin();
-         iter != op2.m_nodeList.end(); ++iter)
-    {
-        m_nodeList.push_back(new Path(**iter));
-    }
-    m_recursive = op2.m_recursive;
+    m_state = op2.m_state;
+    return *this;
+}
+
+/**
+ * op2 is left as the end() iterator.
+ *
+ * @param op2 Right hand side
+ * @return A reference to this object
+ */
+PathIter &PathIter::operator=(PathIter &&op2) noexcept
+{
+    m_state = std::move(op2.m_state);
     return *this;
 }
 
@@ -112,8 +237,7 @@ PathIter &PathIter::operator=(const PathIter &op2)
  */
 Path * PathIter::operator->()
 {
-    Path *  n = findNode(m_current);
-    return n;
+    return &**this;
 }
 
 /**
@@ -123,46 +247,32 @@ Path * PathIter::operator->()
  */
 Path &PathIter::operator*()
 {
-    Path *  n = findNode(m_current);
-    return *n;
+    static Path empty;
+    if (!m_state.get())
+        return empty;
+    return m_state->m_path;
 }
 
 /**
- * Prefix increment moves to the next Node.
+ * Prefix increment moves to the next Node.  If this
+ * shares its state with a copy, it gets its own first.
  *
  * @return Reference to this NodIter
  */
 PathIter &PathIter::operator++()
 {
-    if (m_current < 0 || m_current + 1 >= size())
-    {
-        m_current = -1;
+    if (atEnd())
         return *this;
-    }
-    while (++m_current < size())
-    {
-        Path *p = findNode(m_current);
-        if (m_recursive)
-        {
-            if (p && p->isDir())
-                addNodes(p);
-        }
-        if (p && match(*p))
-            break;
-    }
-    if (m_current == size())
-    {
-        m_current = -1;
-    }
+    unshare().advance();
     return *this;
 }
 
 /**
  * Postfix increment.
  *
- * It's much, much better to use the pre-fix increment as
- * this one makes a complete copy of the list of subnodes
- * and other data.
+ * It's better to use the pre-fix increment as this one
+ * makes a copy of every directory being iterated through
+ * for the iterator that is returned.
  */
 PathIter PathIter::operator++(int)
 {
@@ -179,20 +289,18 @@ PathIter PathIter::operator++(int)
  */
 bool PathIter::operator==(const PathIter & op2) const
 {
-    (void) findNode(m_current);
-
     // Most comparisons are non-end against end() so make sure that is fast.
-    if (m_current != op2.m_current)
+    bool    end = atEnd();
+    if (end != op2.atEnd())
         return false;
-    // obvious case
-    if (this == &op2)
+    // end() or copies that haven't moved
+    if (end || m_state.get() == op2.m_state.get())
         return true;
-    if (m_parent == op2.m_parent && m_current == op2.m_current)
-        return true;
-    // now check for end()
-    if (m_current == -1 && op2.m_current == -1)
-        return true;
-    return false;
+    const State &s1 = *m_state.get();
+    const State &s2 = *op2.m_state.get();
+    if (s1.m_parent != s2.m_parent || s1.m_depth != s2.m_depth)
+        return false;
+    return s1.m_path == s2.m_path;
 }
 
 /**
@@ -206,18 +314,16 @@ bool PathIter::operator!=(const PathIter & op2) const
 }
 
 /**
- * Add a Path to the list that we are traversing.  Creates
- * a new Path.  If the PathIter already reached
- * the end, then this gets added and the PathIter
+ * Add a Path to the list that we are traversing.  It is
+ * visited after everything else.  If the PathIter already
+ * reached the end, then this gets added and the PathIter
  * can be incremented again.
  *
  * @param path The path added to end of list
  */
 void PathIter::addPath(const Path &path)
 {
-    m_nodeList.push_back(new Path(path));
-    if (m_current == -1)
-        m_current = size() - 1;
+    unshare().addPath(path);
 }
 
 /**
@@ -231,67 +337,601 @@ void PathIter::addPath(const Path &path)
  * If you call it after incrementing the iterator it
  * won't scan any of the previous subdirectories.
  *
+ * DEPTH_FIRST and IN_ORDER keep one directory open (or at least
+ * read) for each level between the starting Node and the current
+ * entry.  BREADTH_FIRST reads one directory at a time but keeps
+ * the Path of every subdirectory it has yet to read; for a wide
+ * tree that is a lot more than the depth first stack.
+ *
+ * @param order How to visit the subdirectories
  * @return A reference to this object
  */
-PathIter & PathIter::setRecursive()
+PathIter & PathIter::setRecursive(TraversalOrder order)
 {
-    if (m_recursive)
-        return *this;
-    m_recursive = true;
-    Path *n = findNode(m_current);
-    if (n && n->isDir())
-        addNodes(n);
+    State   &state = unshare();
+    state.m_recursive = true;
+    state.m_traversal = order;
+    state.reorder();
     return *this;
 }
 
 /**
- * Return how many files are in this directory
+ * Each directory is sorted as it is read, BYTEWISE by default.
+ * UNSORTED leaves them in the order the system returns them,
+ * which is fastest for a huge directory.  IN_ORDER traversal
+ * is always UNSORTED.
+ *
+ * Like setRecursive(), call this before incrementing the
+ * iterator so the starting directory is sorted, too.
  *
- * @return Number of items
+ * @param how How to sort the entries in each directory
+ * @return A reference to this object
  */
-int PathIter::size() const
+PathIter & PathIter::setSort(DirEntries::SortOrder how)
 {
-    return static_cast<int>(m_nodeList.size());
+    State   &state = unshare();
+    state.m_sort = how;
+    state.reorder();
+    return *this;
 }
 
+/**
+ * Keeps each directory open while its entries are visited so
+ * subdirectories are opened, and symbolic links checked, relative
+ * to it.  This saves the system from looking up every component of
+ * the full path again for each directory in a deep tree, and the
+ * full path of an entry is only built if you ask for it.
+ *
+ * Call it at the beginning like setRecursive():
+ *
+ * @code
+ * Node::iterator iter = node.begin().setRelative().setRecursive();
+ * @endcode
+ *
+ * @return A reference to this object
+ */
+PathIter & PathIter::setRelative()
+{
+    unshare().setRelative();
+    return *this;
+}
+
+/**
+ * Skips everything in the current entry, if it is a directory,
+ * without reading it.  Only has an effect with setRecursive().
+ *
+ * @code
+ * for (PathIter iter = node.begin().setRecursive(); iter != node.end(); ++iter)
+ * {
+ *     if (iter->basename() == ".git")
+ *         iter.prune();
+ * }
+ * @endcode
+ */
+void PathIter::prune()
+{
+    if (atEnd())
+        return;
+    unshare().m_pruned = true;
+}
+
+/**
+ * Only descends into the directories filter returns true for.
+ * The others are still visited but nothing in them is read.
+ * The filter is called before the directory is opened.
+ *
+ * @param filter Given each subdirectory; null accepts them all
+ * @return A reference to this object
+ */
+PathIter & PathIter::setDirFilter(const DirFilter &filter)
+{
+    State   &state = unshare();
+    state.m_filter = filter;
+    state.reorder();
+    return *this;
+}
+
+/**
+ * Limit how far setRecursive() goes.  The contents of the
+ * starting Node are at depth 0 so setMaxDepth(0) is the same as
+ * not being recursive, and setMaxDepth(1) also visits what is in
+ * each of its subdirectories.  Directories deeper than that are
+ * visited but never opened.
+ *
+ * @param depth The most levels of subdirectories to read
+ * @return A reference to this object
+ */
+PathIter & PathIter::setMaxDepth(size_t depth)
+{
+    State   &state = unshare();
+    state.m_maxDepth = depth;
+    state.reorder();
+    return *this;
+}
 
 /**
- * Check if this path matches the glob() pattern.  Uses the
- * Path::basename() to compare against
+ * Check if this path matches the pattern given to the constructor.
+ * Uses the Path::basename() to compare against.  The iterator
+ * already skips what doesn't match without using this.
  *
  * @param path The path to match
- * @return true if it matches the pattern
+ * @return true if it matches the pattern or there isn't one
  */
 bool PathIter::match(const Path &path) const
 {
-    return true;
+    const State *state = m_state.get();
+    if (!state || !state->m_match.get())
+        return true;
+    return state->m_match.get()->match(path.basename());
 }
 
 /**
- * @param index First is 0.
- * @return Node refered by index.
+ * @return True if there is nothing left to visit
  */
-Path *PathIter::findNode(int index) const
+bool PathIter::atEnd() const
 {
-    if (index < 0 || index >= static_cast<int>(m_nodeList.size()))
-        return 0;
+    return !m_state.get() || m_state.get()->m_depth == 0;
+}
+
+/**
+ * Copies the State if another PathIter is using it.
+ * The end() iterator gets an empty State.
+ *
+ * @return The State only this is using
+ */
+PathIter::State &PathIter::unshare()
+{
+    if (!m_state.get())
+        m_state = Refcount<State>(new State(0));
+    else if (m_state.count() > 1)
+        m_state = Refcount<State>(new State(*m_state.get()));
+    return *m_state;
+}
+
+/**
+ * @param parent The Node being iterated over
+ */
+PathIter::State::State(const Path *parent)
+    : RefcountBase(),
+      m_parent(parent),
+      m_stack(),
+      m_depth(0),
+      m_path(),
+      m_recursive(false),
+      m_traversal(DEPTH_FIRST),
+      m_sort(DirEntries::BYTEWISE),
+      m_frontier(),
+      m_pruned(false),
+      m_filter(),
+      m_maxDepth(std::numeric_limits<size_t>::max()),
+      m_relative(false),
+      m_match(),
+      m_started(false)
+{
+}
+
+/**
+ * Only copies the directories between the starting Node and the
+ * current entry.  Directories opened by setRelative() are not
+ * shared so the copy reads any further subdirectories by path.
+ *
+ * @param copy The State to copy
+ */
+PathIter::State::State(const State &copy)
+    : RefcountBase(),
+      m_parent(copy.m_parent),
+      m_stack(copy.m_stack.begin(), copy.m_stack.begin() + copy.m_depth),
+      m_depth(copy.m_depth),
+      m_path(copy.m_path),
+      m_recursive(copy.m_recursive),
+      m_traversal(copy.m_traversal),
+      m_sort(copy.m_sort),
+      m_frontier(copy.m_frontier),
+      m_pruned(copy.m_pruned),
+      m_filter(copy.m_filter),
+      m_maxDepth(copy.m_maxDepth),
+      m_relative(copy.m_relative),
+      m_match(copy.m_match),
+      m_started(copy.m_started)
+{
+    for (size_t i = 0; i < m_depth; ++i)
+        m_stack[i].m_fd = -1;
+}
+
+PathIter::State::~State()
+{
+    while (m_depth > 0)
+        pop();
+}
+
+/**
+ * Reads a directory and makes it the one being iterated through.
+ * With setRelative() it is opened relative to dirfd if possible.
+ *
+ * @param dir The directory to read
+ * @param name Its name in dirfd
+ * @param dirfd The open directory holding it or -1
+ * @param level How many levels below the starting Node dir is
+ */
+void PathIter::State::push(const Path &dir, const char *name, int dirfd, size_t level)
+{
+    // Cursors beyond m_depth are reused to keep their memory
+    if (m_depth == m_stack.size())
+        m_stack.resize(m_depth + 1);
+    Cursor &c = m_stack[m_depth++];
+    c.m_dir = dir;
+    c.m_order.clear();
+    c.m_extra.clear();
+    c.m_index = 0;
+    c.m_level = level;
+    c.m_fd = -1;
+
+    int     fd = -1;
+    if (m_relative)
+    {
+        if (dirfd >= 0 && name)
+            fd = System.opendirat(dirfd, name);
+        if (fd < 0)
+            fd = System.opendir(dir.path());
+    }
+    bool    status = fd >= 0 ? System.readdir(fd, c.m_entries)
+                             : System.readdir(dir.path(), c.m_entries);
+    if (!status)
+        c.m_entries.clear();
+
+    bool    subdirs = false;
+    for (size_t i = 0; i < c.m_entries.size() && !subdirs; ++i)
+    {
+        NodeInfo::Type  type = c.m_entries[i].type;
+        if (type == NodeInfo::DIRECTORY || type == NodeInfo::SYMLINK || type == NodeInfo::UNKNOWN)
+            subdirs = true;
+    }
+    order(c);
+
+    // Only keep it open if it might be needed for a subdirectory
+    if (fd >= 0 && subdirs && m_depth <= s_maxOpen)
+        c.m_fd = fd;
+    else
+        System.closedir(fd);
+}
+
+/**
+ * Closes the top directory but keeps the memory for
+ * the next push().
+ */
+void PathIter::State::pop()
+{
+    Cursor &c = m_stack[--m_depth];
+    System.closedir(c.m_fd);
+    c.m_fd = -1;
+}
+
+/**
+ * Going depth first, this visits everything in a directory
+ * before its next sibling.  Going breadth first, the directory
+ * is left for settle() to read once everything at this level
+ * has been visited.
+ */
+void PathIter::State::advance()
+{
+    if (m_depth == 0)
+        return;
+    m_started = true;
+    step();
+    settle();
+}
+
+/**
+ * Does the work of advance() except finding the next entry.
+ */
+void PathIter::State::step()
+{
+    bool    down = descend();
+    m_pruned = false;
+    if (down && m_traversal == BREADTH_FIRST)
+    {
+        Cursor &c = m_stack[m_depth - 1];
+        m_frontier.push_back(std::make_pair(m_path, c.m_level + 1));
+        ++c.m_index;
+    }
+    else if (down)
+    {
+        if (m_depth == m_stack.size())
+            m_stack.resize(m_depth + 1);
+        // push() can't resize m_stack now so the name stays put
+        Cursor &c = m_stack[m_depth - 1];
+        size_t  index = c.m_index++;
+        push(m_path, c.name(index), c.m_fd, c.m_level + 1);
+    }
+    else
+    {
+        ++m_stack[m_depth - 1].m_index;
+    }
+}
 
-    return m_nodeList[index];
+/**
+ * Pops every directory that has been finished and reads the next
+ * one waiting in m_frontier.  If there are none, this becomes the
+ * end() iterator.
+ *
+ * Entries whose name doesn't match m_match are skipped.  One that
+ * may be a directory to go into still needs a Path for that but
+ * anything else is skipped by name alone.
+ */
+void PathIter::State::settle()
+{
+    while (m_depth > 0)
+    {
+        Cursor &c = m_stack[m_depth - 1];
+        if (c.m_index < c.m_order.size())
+        {
+            DirEntry    entry = c.m_entries[c.m_order[c.m_index]];
+            bool    skip = m_match.get() && !m_match->match(entry.name);
+            if (skip && (!m_recursive || entry.type == NodeInfo::FILE
+                         || entry.type == NodeInfo::DEVICE || entry.type == NodeInfo::OTHER))
+            {
+                ++c.m_index;
+                continue;
+            }
+            m_path = c.m_dir / entry.name;
+            listed(entry);
+            if (!skip)
+                return;
+            step();
+            continue;
+        }
+        if (c.m_index < c.size())
+        {
+            m_path = c.m_extra[c.m_index - c.m_order.size()];
+            if (!m_match.get() || m_match->match(m_path.basename()))
+                return;
+            step();
+            continue;
+        }
+        pop();
+        if (m_depth == 0 && !m_frontier.empty())
+        {
+            std::pair<Path, size_t> dir(std::move(m_frontier.front()));
+            m_frontier.pop_front();
+            push(dir.first, 0, -1, dir.second);
+        }
+    }
+    m_path = Path();
 }
 
 /**
- * @param node Add list of subnodes from node
+ * Lets m_path use the type from readdir() without calling stat().
+ * Symbolic links are left alone as Path::info() follows them.
+ * The inode of a directory isn't kept as it is wrong for a mount
+ * point.
+ *
+ * @param entry The entry m_path was made from
  */
-void PathIter::addNodes(const Path *node)
+void PathIter::State::listed(const DirEntry &entry)
 {
-    if (!node)
+    if (entry.type == NodeInfo::UNKNOWN || entry.type == NodeInfo::SYMLINK)
         return;
+    m_path.listed(entry.type, entry.type == NodeInfo::DIRECTORY ? 0 : entry.inode);
+}
+
+/**
+ * Sorts without copying any of the names.  Going IN_ORDER,
+ * they are left in the order they were read.
+ *
+ * @param c The Cursor to put in order
+ */
+void PathIter::State::order(Cursor &c) const
+{
+    c.m_sorted = sortOrder();
+    c.m_entries.sort(c.m_order, c.m_sorted);
+}
+
+/**
+ * @return UNSORTED going IN_ORDER otherwise what setSort() chose
+ */
+DirEntries::SortOrder PathIter::State::sortOrder() const
+{
+    return m_traversal == IN_ORDER ? DirEntries::UNSORTED : m_sort;
+}
 
-    Strings files = System.listdir(node->path());
-    std::sort(files.begin(), files.end());
-    for (Strings::iterator iter = files.begin(); iter != files.end(); ++iter)
+/**
+ * The starting directory was read before the order was known.
+ * If nothing in it has been visited yet, it is put in the
+ * new order.
+ *
+ * With a pattern, settle() may already have gone past entries
+ * that don't match, or even finished, so until advance() is called
+ * it starts over from the first entry of the starting directory.
+ * That is still in m_stack[0] after pop() unless going breadth
+ * first read another directory over it.
+ */
+void PathIter::State::reorder()
+{
+    if (m_match.get() && !m_started && !m_stack.empty() && m_stack[0].m_level == 0)
+    {
+        while (m_depth > 1)
+            pop();
+        m_depth = 1;
+        m_frontier.clear();
+        Cursor &c = m_stack[0];
+        c.m_index = 0;
+        if (c.m_sorted != sortOrder())
+            order(c);
+        settle();
+        return;
+    }
+    if (m_depth != 1)
+        return;
+    Cursor &c = m_stack[0];
+    if (c.m_index == 0 && !c.m_order.empty() && c.m_sorted != sortOrder())
     {
-        m_nodeList.push_back(new Path(*node / *iter));
+        order(c);
+        settle();
     }
 }
+
+/**
+ * Checks everything that doesn't need a system call before
+ * isDir(), and the filter only gets directories.
+ *
+ * @return True if the entry being visited is a directory to read
+ */
+bool PathIter::State::descend() const
+{
+    if (!m_recursive || m_pruned)
+        return false;
+    if (m_stack[m_depth - 1].m_level >= m_maxDepth)
+        return false;
+    if (!isDir())
+        return false;
+    return !m_filter || m_filter(m_path);
+}
+
+/**
+ * Uses the type from readdir() when it is known so there is
+ * no need to stat() the Path.  Symbolic links are followed with
+ * Path::isDir() like any other Path, or with SysBase::statat()
+ * if the directory holding it is open.  Either way an exception
+ * names the whole path, not just the entry.
+ *
+ * @return True if the entry being visited is a directory
+ */
+bool PathIter::State::isDir() const
+{
+    const Cursor &c = m_stack[m_depth - 1];
+    switch (c.type(c.m_index))
+    {
+    case NodeInfo::DIRECTORY:
+        return true;
+    case NodeInfo::FILE:
+    case NodeInfo::DEVICE:
+    case NodeInfo::OTHER:
+        return false;
+    default:
+        break;
+    }
+    const char *name = c.name(c.m_index);
+    if (c.m_fd >= 0 && name)
+    {
+        NodeInfo *info;
+        try
+        {
+            info = System.statat(c.m_fd, name, NodeInfo::TYPE);
+        }
+        catch (const PathPermissionException &e)
+        {
+            throw PathPermissionException(m_path.path(), e.err());
+        }
+        catch (const PathBadException &e)
+        {
+            throw PathBadException(m_path.path(), e.err());
+        }
+        catch (const PathException &e)
+        {
+            throw PathException(m_path.path(), e.err());
+        }
+        bool    result = info->isDir();
+        delete info;
+        return result;
+    }
+    return m_path.isDir();
+}
+
+/**
+ * @param path Visited after everything else
+ */
+void PathIter::State::addPath(const Path &path)
+{
+    if (m_depth == 0)
+    {
+        if (m_stack.empty())
+            m_stack.resize(1);
+        Cursor &c = m_stack[0];
+        c.m_dir = Path();
+        c.m_entries.clear();
+        c.m_order.clear();
+        c.m_extra.clear();
+        c.m_index = 0;
+        c.m_level = 0;
+        c.m_sorted = DirEntries::UNSORTED;
+        c.m_fd = -1;
+        m_depth = 1;
+    }
+    m_stack[0].m_extra.push_back(path);
+    settle();
+}
+
+/**
+ * The directories already read are opened now so
+ * their subdirectories can be opened relative to them.
+ */
+void PathIter::State::setRelative()
+{
+    m_relative = true;
+    if (m_depth > 0)
+    {
+        Cursor &c = m_stack[m_depth - 1];
+        if (c.m_fd < 0 && c.m_extra.empty())
+            c.m_fd = System.opendir(c.m_dir.path());
+    }
+}
+
+/**
+ * @param pattern A shell pattern or regular expression
+ * @param regexp True if pattern is a regular expression
+ */
+PathIter::State::Matcher::Matcher(const std::string &pattern, bool regexp)
+    : RefcountBase(),
+      m_regexp(regexp),
+      m_glob(regexp ? std::string() : pattern),
+      m_regex()
+{
+    if (regexp)
+        m_regex.assign(pattern, std::regex::ECMAScript | std::regex::optimize);
+}
+
+/**
+ * @param name The name of an entry, not its full path
+ * @return True if the whole name matches the Glob or the regular
+ *      expression is found in it
+ */
+bool PathIter::State::Matcher::match(std::string_view name) const
+{
+    if (m_regexp)
+        return std::regex_search(name.begin(), name.end(), m_regex);
+    return m_glob.match(name);
+}
+
+/**
+ * @return Number of entries including any from addPath()
+ */
+size_t PathIter::State::Cursor::size() const
+{
+    return m_order.size() + m_extra.size();
+}
+
+/**
+ * The names are followed by a '\0' so they can be
+ * passed to SysBase directly.
+ *
+ * @param index Which entry
+ * @return The name or null if it came from addPath()
+ */
+const char *PathIter::State::Cursor::name(size_t index) const
+{
+    if (index >= m_order.size())
+        return 0;
+    return m_entries[m_order[index]].name.data();
+}
+
+/**
+ * @param index Which entry
+ * @return Its type from readdir() or NodeInfo::UNKNOWN
+ */
+NodeInfo::Type PathIter::State::Cursor::type(size_t index) const
+{
+    if (index >= m_order.size())
+        return NodeInfo::UNKNOWN;
+    return m_entries[m_order[index]].type;
+}
 }
@@ -0,0 +1,105 @@
+/**
+ * @file PathTable.cpp
+ */
+#include <path/PathTable.h>
+#include <path/PathExtra.h>
+#include <path/Canonical.h>
+
+namespace path {
+
+PathTable::PathTable()
+    : m_paths(),
+      m_index()
+{
+}
+
+/**
+ * Any Paths still referring to this table revert to being
+ * compared by value.
+ */
+PathTable::~PathTable()
+{
+    clear();
+}
+
+/**
+ * If an equal Path (see operator==()) is already in the table, that
+ * Path is returned.  Otherwise a copy of path is added and returned.
+ *
+ * @param path The Path to look for
+ * @return The Path in this table equal to path
+ */
+Path PathTable::intern(const Path &path)
+{
+    return m_paths[id(path)];
+}
+
+/**
+ * @param path The Path to look for
+ * @return The Id of the Path in this table equal to path
+ */
+PathTable::Id PathTable::id(const Path &path)
+{
+    if (contains(path))
+        return path.meta()->m_id.load(std::memory_order_relaxed);
+
+    size_t  h = path.hash();
+    typedef std::unordered_multimap<size_t, Id>::const_iterator Iter;
+    std::pair<Iter, Iter> range = m_index.equal_range(h);
+    for (Iter iter = range.first; iter != range.second; ++iter)
+    {
+        if (m_paths[iter->second] == path)
+            return iter->second;
+    }
+
+    // Make a private copy so it doesn't share any cached
+    // strings or parents with the original
+    Path    p(path.canon(), path.pathRules());
+    Id      newId = static_cast<Id>(m_paths.size());
+    p.m_meta->m_table.store(this, std::memory_order_relaxed);
+    p.m_meta->m_id.store(newId, std::memory_order_relaxed);
+    m_paths.push_back(p);
+    m_index.insert(std::make_pair(h, newId));
+    return newId;
+}
+
+/**
+ * @param path The Path to check
+ * @return true if path was returned by intern() and shares this table's copy
+ */
+bool PathTable::contains(const Path &path) const
+{
+    return path.meta()->m_table.load(std::memory_order_relaxed) == this;
+}
+
+/**
+ * @param id An Id returned by id()
+ * @return The Path with that id
+ */
+const Path &PathTable::operator[](Id id) const
+{
+    return m_paths[id];
+}
+
+/**
+ * @return The number of distinct Paths
+ */
+size_t PathTable::size() const
+{
+    return m_paths.size();
+}
+
+/**
+ * Paths previously returned by intern() are still valid but
+ * no longer associated with this table.  Other threads may still
+ * compare them meanwhile; they just stop taking the shortcut.
+ */
+void PathTable::clear()
+{
+    for (Paths::iterator iter = m_paths.begin(); iter != m_paths.end(); ++iter)
+        iter->m_meta->m_table.store(0, std::memory_order_relaxed);
+    m_paths.clear();
+    m_index.clear();
+}
+
+}
@@ -34,36 +34,66 @@ RulesBase::~RulesBase()
  */
 std::string RulesBase::str(const Canonical &canon) const
 {
-    std::string     pathStr
-    ;
-    if (!canon.protocol().empty())
+    ComponentView view = canon.view();
+
+    // Only components needing quote() are copied; usually none
+    // and when canon was parsed by these rules none are checked.
+    std::vector<std::pair<size_t, std::string> > quoted;
+    if (canon.plain() != this)
     {
-        pathStr += canon.protocol() + ":";
-        if (!canon.host().empty())
-            pathStr += "//" + canon.host() + "/";
+        for (size_t i = 0; i < view.size(); ++i)
+        {
+            if (needsQuote(view[i]))
+            {
+                quoted.push_back(std::make_pair(i, std::string()));
+                quote(std::string(view[i]), &quoted.back().second);
+            }
+        }
     }
+
+    // Work out the exact size so there is a single allocation
+    const bool  host = !canon.protocol().empty() && !canon.host().empty();
+    size_t      size = 0;
+    if (!canon.protocol().empty())
+        size += canon.protocol().size() + 1;
+    if (host)
+        size += canon.host().size() + 3;
     if (!canon.drive().empty())
+        size += canon.drive().size() + 1;
+    if (canon.abs())
+        ++size;
+    if (!view.empty())
+        size += view.size() - 1;
+    std::vector<std::pair<size_t, std::string> >::const_iterator q = quoted.begin();
+    for (size_t i = 0; i < view.size(); ++i)
     {
-        pathStr += canon.drive() + ":";
+        if (q != quoted.end() && q->first == i)
+            size += (q++)->second.size();
+        else
+            size += view[i].size();
+    }
+
+    std::string     pathStr;
+    pathStr.reserve(size);
+    if (!canon.protocol().empty())
+    {
+        pathStr.append(canon.protocol()).append(1, ':');
+        if (host)
+            pathStr.append("//").append(canon.host()).append(1, '/');
     }
+    if (!canon.drive().empty())
+        pathStr.append(canon.drive()).append(1, ':');
     if (canon.abs())
-        pathStr += m_sep;
-    bool first = true;
-    for (Strings::const_iterator iter = canon.components().begin();
-         iter != canon.components().end(); ++iter)
+        pathStr.append(1, m_sep);
+    q = quoted.begin();
+    for (size_t i = 0; i < view.size(); ++i)
     {
-        if (first)
-            first = false;
+        if (i)
+            pathStr.append(1, m_sep);
+        if (q != quoted.end() && q->first == i)
+            pathStr.append((q++)->second);
         else
-            pathStr += m_sep;
-        if (!quote(*iter, 0))
-            pathStr += *iter;
-        else 
-        {
-            std::string quoteStr;
-            //quote(*iter, &quoteStr);
-            pathStr += quoteStr;
-        }
+            pathStr.append(view[i].data(), view[i].size());
     }
     return pathStr;
 }
@@ -75,35 +105,42 @@ std::string RulesBase::str(const Canonical &canon) const
  * @param path The path to convert to Canonical
  * @return Canonical representation of path
  */
-Canonical RulesBase::canonical(const std::string &path) const
+Canonical RulesBase::canonical(std::string_view path) const
 {
     Canonical       canon;
-    Strings     components;
-    bool            first = true;
 
-    split(path, m_sep, components);
-    Strings::iterator iter = components.begin();
-    while (iter != components.end())
+    if (!path.empty() && path[0] == m_sep)
+        canon.setAbs(true);
+    // Each component is copied straight from path; empty
+    // ones (e.g. "a//b" or a trailing seperator) are skipped
+    Splitter            splitter(path, m_sep);
+    std::string_view    component;
+    while (splitter.next(component))
     {
-        if (iter->empty())
-        {
-            if (first)
-                canon.setAbs(true);
-            iter = components.erase(iter);
-        }
-        else {
-            // The previous erase goes to the next component
-            // and a second ++iter in for loop would go beyond
-            // the end
-            ++iter;
-        }
-        first = false;
-
+        if (!component.empty())
+            canon.add(component);
     }
-    canon.components().swap(components);
+    // A component can't contain the seperator so nothing needs quoting
+    // (assuming quote() only changes the seperator; see needsQuote())
+    canon.setPlain(this);
     return canon;
 }
 
+/**
+ * Used by str() to check each component before calling quote().
+ * The default is true if subdir contains the seperator.  Rules
+ * that quote other characters must override this.  This must only
+ * depend on the individual characters since Canonical only checks
+ * the new characters when a component is extended.
+ *
+ * @param subdir A single component
+ * @return True if quote() would change subdir
+ */
+bool RulesBase::needsQuote(std::string_view subdir) const
+{
+    return subdir.find(m_sep) != std::string_view::npos;
+}
+
 /**
  * Return a string properly quoted with any system special components replaces.
  * For example, RulesUri would replace spaces with %040.  Only single path
@@ -25,7 +25,7 @@ RulesUnix::~RulesUnix()
  *
  * @param path A string to parse into a path.
  */
-Canonical RulesUnix::canonical(const std::string &path) const
+Canonical RulesUnix::canonical(std::string_view path) const
 {
     return RulesBase::canonical(path);
 }
@@ -179,7 +179,7 @@ bool RulesUnix::unquote(const std::string &p, std::string *dest) const
  * @param path A string with a Unix style path
  * @return A Canonical object representing that path
  */
-path::Canonical UnixPath(const std::string &path)
+path::Canonical UnixPath(std::string_view path)
 {
     return path::RulesUnix::rules.canonical(path);
 }
@@ -21,7 +21,7 @@ RulesUri::~RulesUri()
  *
  * @param path A string to parse into a path.
  */
-Canonical RulesUri::canonical(const std::string &path) const
+Canonical RulesUri::canonical(std::string_view) const
 {
     return Canonical();
 }
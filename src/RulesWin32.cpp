@@ -26,14 +26,14 @@ RulesWin32::~RulesWin32()
  *
  * @param path A string to parse into a path.
  */
-Canonical RulesWin32::canonical(const std::string &path) const
+Canonical RulesWin32::canonical(std::string_view path) const
 {
     Canonical canon;
 
     if (path.size() >= 2 && path[1] == ':')
     {
-        canon = RulesBase::canonical(path.substr(2, path.size() - 2));
-        canon.setDrive(path.substr(0,1));
+        canon = RulesBase::canonical(path.substr(2));
+        canon.setDrive(std::string(path.substr(0,1)));
         canon.setAbs(true);
     }
     else
@@ -60,6 +60,15 @@ bool RulesWin32::quote(const std::string & path, std::string *dest) const
     return false;
 }
 
+/**
+ * @param subdir The component to check
+ * @return Always false since quote() doesn't change anything
+ */
+bool RulesWin32::needsQuote(std::string_view) const
+{
+    return false;
+}
+
 bool RulesWin32::unquote(const std::string & subdir, std::string *dest) const
 {
     if (dest)
@@ -89,7 +98,7 @@ bool RulesWin32::unquote(const std::string & subdir, std::string *dest) const
  * @param path A string with a Windows/DOS style path
  * @return A Canonical object representing that path
  */
-path::Canonical Win32Path(const std::string &path)
+path::Canonical Win32Path(std::string_view path)
 {
     return path::RulesWin32::rules.canonical(path);
 }
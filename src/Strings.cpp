@@ -3,6 +3,12 @@
  */
 #include <path/Strings.h>
 
+#include <cstring>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
 namespace path
 {
 /**
@@ -139,18 +145,138 @@ std::string expand(const std::string &str, const StringMap &vars, bool tilde)
  * @param sep The character to use to split the path
  * @param strings vector of strings that each component is push_back()'d on
  */
-void split(const std::string &word, char sep, Strings &strings)
+void split(std::string_view word, char sep, Strings &strings)
+{
+    Splitter            splitter(word, sep);
+    std::string_view    component;
+
+    while (splitter.next(component))
+        strings.push_back(std::string(component));
+}
+
+/**
+ * Return the index of the lowest bit set in mask.
+ *
+ * @param mask Must not be 0
+ * @return The index (0 to 63)
+ */
+static inline unsigned int lowestBit(uint64_t mask)
+{
+#if defined(__GNUC__)
+    return static_cast<unsigned int>(__builtin_ctzll(mask));
+#else
+    unsigned int bit = 0;
+    while (!(mask & 1))
+    {
+        mask >>= 1;
+        ++bit;
+    }
+    return bit;
+#endif
+}
+
+/**
+ * @param str The string to split
+ * @param sep The seperator between components
+ */
+Splitter::Splitter(std::string_view str, char sep)
+    : m_str(str),
+      m_sep(sep),
+      m_start(0),
+      m_base(0),
+      m_mask(str.empty() ? 0 : block(0)),
+      m_done(str.empty())
+{
+}
+
+/**
+ * The returned component refers to the original string.
+ *
+ * @param component Set to the next component
+ * @return false if there are no more components
+ */
+bool Splitter::next(std::string_view &component)
+{
+    if (m_done)
+        return false;
+    size_t  end = nextSeparator();
+    if (end == std::string_view::npos)
+    {
+        component = m_str.substr(m_start);
+        m_done = true;
+    }
+    else
+    {
+        component = m_str.substr(m_start, end - m_start);
+        m_start = end + 1;
+    }
+    return true;
+}
+
+/**
+ * Uses the bits left in m_mask and scans the following
+ * blocks as needed.
+ *
+ * @return Offset of the next seperator or npos if none are left
+ */
+size_t Splitter::nextSeparator()
 {
-    std::string::size_type  start = 0;
-    std::string::size_type  end = 0;
+    while (!m_mask)
+    {
+        m_base += 64;
+        if (m_base >= m_str.size())
+            return std::string_view::npos;
+        m_mask = block(m_base);
+    }
+    size_t  pos = m_base + lowestBit(m_mask);
+    m_mask &= m_mask - 1;
+    return pos;
+}
 
-    while (start < word.size() && end != std::string::npos)
+/**
+ * Compare 64 bytes at a time against the seperator.  The
+ * last partial block is copied so nothing past the end of
+ * the string is read.
+ *
+ * @param offset Start of the block in m_str
+ * @return Bit n is set if m_str[offset + n] is the seperator
+ */
+uint64_t Splitter::block(size_t offset) const
+{
+    const char *    p = m_str.data() + offset;
+    size_t          len = m_str.size() - offset;
+    char            buf[64];
+    if (len < 64)
+    {
+        std::memcpy(buf, p, len);
+        std::memset(buf + len, m_sep ^ 1, 64 - len);
+        p = buf;
+    }
+
+    uint64_t    mask = 0;
+#if defined(__AVX2__)
+    const __m256i   sep = _mm256_set1_epi8(m_sep);
+    for (int i = 0; i < 2; ++i)
+    {
+        __m256i     bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + 32 * i));
+        uint32_t    bits = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, sep)));
+        mask |= static_cast<uint64_t>(bits) << (32 * i);
+    }
+#elif defined(__SSE2__)
+    const __m128i   sep = _mm_set1_epi8(m_sep);
+    for (int i = 0; i < 4; ++i)
+    {
+        __m128i     bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 16 * i));
+        uint32_t    bits = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, sep)));
+        mask |= static_cast<uint64_t>(bits) << (16 * i);
+    }
+#else
+    for (int i = 0; i < 64; ++i)
     {
-        end = word.find_first_of(sep, start);
-        strings.push_back(word.substr(start, end - start));
-        if (end == word.size() - 1)
-            strings.push_back(std::string(""));
-        start = end + 1;
+        if (p[i] == m_sep)
+            mask |= static_cast<uint64_t>(1) << i;
     }
+#endif
+    return mask;
 }
 }
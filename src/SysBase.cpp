@@ -47,18 +47,103 @@ Strings SysBase::listdir(const std::string &path) const
     throw Unimplemented("SysBase::listdir");
 }
 
+/**
+ * Replaces entries with the contents of dir (except "." and "..").
+ * This default uses listdir() so the type of each entry is
+ * NodeInfo::UNKNOWN.
+ *
+ * @param dir The directory to read
+ * @param entries Where to put the entries; it is cleared first
+ * @return false if dir could not be read
+ */
+bool SysBase::readdir(const std::string &dir, DirEntries &entries) const
+{
+    entries.clear();
+    Strings names = listdir(dir);
+    for (Strings::const_iterator iter = names.begin(); iter != names.end(); ++iter)
+        entries.add(*iter, NodeInfo::UNKNOWN, 0);
+    return true;
+}
+
+/**
+ * Systems that can't work relative to an open directory
+ * return -1 so callers use full paths instead.
+ *
+ * @param dir The directory to open
+ * @return A descriptor for the other calls or -1
+ */
+int SysBase::opendir(const std::string &dir) const
+{
+    return -1;
+}
+
+/**
+ * @param dirfd From opendir() or opendirat()
+ * @param name A subdirectory of dirfd
+ * @return A descriptor for the other calls or -1
+ */
+int SysBase::opendirat(int dirfd, const char *name) const
+{
+    return -1;
+}
+
+/**
+ * @param dirfd From opendir() or opendirat()
+ */
+void SysBase::closedir(int dirfd) const
+{
+}
+
+/**
+ * @param dirfd From opendir() or opendirat()
+ * @param entries Replaced with the contents except "." and ".."
+ * @return false if dirfd could not be read
+ */
+bool SysBase::readdir(int dirfd, DirEntries &entries) const
+{
+    entries.clear();
+    return false;
+}
+
 /**
  * Gets the basic information about a file and returns
  * the a new NodeInfo object.
  *
  * @param path The path to look for
+ * @param fields NodeInfo::Field bits for what is needed
+ * @param follow If false, return info about a symbolic link
+ *               rather than what it points to (like lstat())
  * @return Newly created NodeInfo object.
  */
-NodeInfo * SysBase::stat(const std::string & path) const
+NodeInfo * SysBase::stat(const std::string & path, unsigned fields, bool follow) const
 {
     throw Unimplemented("SysBase::stat");
 }
 
+/**
+ * Like stat() but name is relative to dirfd.
+ *
+ * @param dirfd From opendir() or opendirat()
+ * @param name The file in dirfd
+ * @param fields NodeInfo::Field bits for what is needed
+ * @param follow If false, return info about a symbolic link
+ * @return Newly created NodeInfo object.
+ */
+NodeInfo * SysBase::statat(int dirfd, const char *name, unsigned fields, bool follow) const
+{
+    throw Unimplemented("SysBase::statat");
+}
+
+/**
+ * @param dirfd From opendir() or opendirat()
+ * @param name The file or directory in dirfd
+ * @param dir True to remove an empty directory, false for a file
+ */
+void SysBase::removeat(int dirfd, const char *name, bool dir) const
+{
+    throw Unimplemented("SysBase::removeat");
+}
+
 bool SysBase::exists(const std::string &path) const
 {
     throw Unimplemented("SysBase::exists");
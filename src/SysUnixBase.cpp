@@ -22,6 +22,12 @@
 #include <sys/stat.h>
 #include <sys/param.h>
 #include <string.h>
+#include <stddef.h>
+#include <stdint.h>
+#endif
+#if defined(__linux__)
+#include <sys/syscall.h>
+#include <sys/sysmacros.h>
 #endif
 
 extern "C" {
@@ -98,77 +104,392 @@ void SysUnixBase::remove(const std::string &file) const
 
 Strings SysUnixBase::listdir(const std::string &path) const
 {
+    Strings     dirs;
+    DirEntries  entries;
+
+    if (!readdir(path, entries))
+        return dirs;
+    dirs.reserve(entries.size());
+    for (size_t i = 0; i < entries.size(); ++i)
+        dirs.push_back(std::string(entries[i].name));
+    return dirs;
+}
+
 #ifdef PW_SYS_LINUX
-    Strings dirs;
+/**
+ * @param d_type The type from a struct dirent
+ * @return The matching NodeInfo::Type
+ */
+static NodeInfo::Type direntType(unsigned char d_type)
+{
+    switch (d_type)
+    {
+    case DT_DIR:
+        return NodeInfo::DIRECTORY;
+    case DT_REG:
+        return NodeInfo::FILE;
+    case DT_LNK:
+        return NodeInfo::SYMLINK;
+    case DT_CHR:
+    case DT_BLK:
+        return NodeInfo::DEVICE;
+    case DT_UNKNOWN:
+        return NodeInfo::UNKNOWN;
+    default:
+        return NodeInfo::OTHER;
+    }
+}
+
+/**
+ * @param name A NUL terminated name
+ * @return True if name is "." or ".."
+ */
+static bool dotOrDotDot(const char *name)
+{
+    return name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'));
+}
+#endif
 
-    DIR *dir = opendir(path.c_str());
+/**
+ * Reads the whole directory into entries.  On Linux this uses
+ * getdents64() to read many entries per system call straight
+ * into the DirEntries buffer.  The type comes from d_type so
+ * callers don't need to stat() each entry unless the file system
+ * doesn't provide it (the type is then NodeInfo::UNKNOWN).
+ *
+ * @param path The directory to read
+ * @param entries Replaced with the contents except "." and ".."
+ * @return false if path could not be opened as a directory
+ */
+bool SysUnixBase::readdir(const std::string &path, DirEntries &entries) const
+{
+#ifdef PW_SYS_LINUX
+    entries.clear();
+#if defined(__linux__)
+    int fd = opendir(path);
+    if (fd < 0)
+        return false;
+    bool status = readdir(fd, entries);
+    closedir(fd);
+    return status;
+#else
+    DIR *dir = ::opendir(path.c_str());
     if (!dir)
-        return dirs;
+        return false;
+    // Each DIR is only used by one thread so readdir() is safe
+    while (struct dirent *entry = ::readdir(dir))
+    {
+        if (!dotOrDotDot(entry->d_name))
+            entries.add(entry->d_name, direntType(entry->d_type), entry->d_ino);
+    }
+    ::closedir(dir);
+    return true;
+#endif
+#else
+    throw Unimplemented ("SysUnixBase::readdir");
+#endif
+}
 
-    struct dirent   *entry_ptr;
-    struct dirent   entry;
-    while (readdir_r(dir, &entry, &entry_ptr) == 0)
+/**
+ * @param dir The directory to open
+ * @return A descriptor for the other calls or -1
+ */
+int SysUnixBase::opendir(const std::string &dir) const
+{
+#ifdef PW_SYS_LINUX
+    return ::open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+#else
+    return -1;
+#endif
+}
+
+/**
+ * Opens a subdirectory without looking up the path to
+ * dirfd again.  Symbolic links are followed.
+ *
+ * @param dirfd From opendir() or opendirat()
+ * @param name A subdirectory of dirfd
+ * @return A descriptor for the other calls or -1
+ */
+int SysUnixBase::opendirat(int dirfd, const char *name) const
+{
+#ifdef PW_SYS_LINUX
+    return ::openat(dirfd, name, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+#else
+    return -1;
+#endif
+}
+
+/**
+ * @param dirfd From opendir() or opendirat()
+ */
+void SysUnixBase::closedir(int dirfd) const
+{
+#ifdef PW_SYS_LINUX
+    if (dirfd >= 0)
+        ::close(dirfd);
+#endif
+}
+
+/**
+ * Same as readdir() with a path.  Reads from the current
+ * position of dirfd, so only read each descriptor once.
+ *
+ * @param dirfd From opendir() or opendirat()
+ * @param entries Replaced with the contents except "." and ".."
+ * @return false if dirfd could not be read
+ */
+bool SysUnixBase::readdir(int dirfd, DirEntries &entries) const
+{
+#ifdef PW_SYS_LINUX
+    entries.clear();
+#if defined(__linux__)
+    /// The layout getdents64() fills in
+    struct linux_dirent64
+    {
+        uint64_t        d_ino;
+        int64_t         d_off;
+        unsigned short  d_reclen;
+        unsigned char   d_type;
+        char            d_name[1];
+    };
+    const size_t    chunk = 32 * 1024;
+    for (;;)
     {
-        if (!entry_ptr)
+        size_t      start = entries.used();
+        const char *buf = entries.space(chunk);
+        long        count = syscall(SYS_getdents64, dirfd, buf, chunk);
+        if (count < 0)
+            return false;
+        if (count == 0)
             break;
-#ifdef notdef
-        if ((entry.d_namlen == 1 || entry.d_namlen == 2) &&
-            (strcmp(entry.d_name, ".") == 0 || strcmp(entry.d_name, "..") == 0))
-            continue;
-#endif
-        if (strcmp(entry.d_name, ".") == 0 || strcmp(entry.d_name, "..") == 0)
-            continue;
-        dirs.push_back(entry.d_name);
+        // Names are used in place; the rest of each record is ignored
+        entries.commit(static_cast<size_t>(count));
+        for (long pos = 0; pos < count;)
+        {
+            const linux_dirent64 *d = reinterpret_cast<const linux_dirent64 *>(buf + pos);
+            if (!dotOrDotDot(d->d_name))
+            {
+                size_t  offset = start + pos + offsetof(linux_dirent64, d_name);
+                entries.addAt(offset, strlen(d->d_name), direntType(d->d_type), d->d_ino);
+            }
+            pos += d->d_reclen;
+        }
     }
-    closedir(dir);
-    return dirs;
+    return true;
 #else
-    throw Unimplemented ("SysUnixBase::listdir");
+    // fdopendir() takes over the descriptor so give it a copy
+    int fd = ::dup(dirfd);
+    DIR *dir = fd < 0 ? 0 : ::fdopendir(fd);
+    if (!dir)
+    {
+        if (fd >= 0)
+            ::close(fd);
+        return false;
+    }
+    while (struct dirent *entry = ::readdir(dir))
+    {
+        if (!dotOrDotDot(entry->d_name))
+            entries.add(entry->d_name, direntType(entry->d_type), entry->d_ino);
+    }
+    ::closedir(dir);
+    return true;
 #endif
+#else
+    throw Unimplemented ("SysUnixBase::readdir");
+#endif
+}
+
+#ifdef PW_SYS_LINUX
+/**
+ * @param mode The st_mode or stx_mode from the system
+ * @return The NodeInfo::Type for the file type bits of mode
+ */
+static NodeInfo::Type modeType(unsigned mode)
+{
+    switch (mode & S_IFMT) {
+    case S_IFDIR:
+        return NodeInfo::DIRECTORY;
+    case S_IFREG:
+        return NodeInfo::FILE;
+    case S_IFLNK:
+        return NodeInfo::SYMLINK;
+    case S_IFCHR:
+    case S_IFBLK:
+        return NodeInfo::DEVICE;
+    default:
+        return NodeInfo::OTHER;
+    }
 }
 
+/**
+ * Copies everything from a struct stat into node
+ */
+static void fromStat(const struct stat &statbuf, NodeInfo *node)
+{
+    node->setType(modeType(statbuf.st_mode))
+        .setMode(statbuf.st_mode & ~S_IFMT)
+        .setSize(statbuf.st_size)
+        .setNlink(statbuf.st_nlink)
+        .setUid(statbuf.st_uid)
+        .setGid(statbuf.st_gid)
+        .setInode(statbuf.st_ino)
+        .setDev(statbuf.st_dev)
+        .setBlocks(statbuf.st_blocks);
+#if defined(__APPLE__)
+    node->setAtime(statbuf.st_atimespec)
+        .setMtime(statbuf.st_mtimespec)
+        .setCtime(statbuf.st_ctimespec)
+        .setBtime(statbuf.st_birthtimespec);
+#else
+    node->setAtime(statbuf.st_atim)
+        .setMtime(statbuf.st_mtim)
+        .setCtime(statbuf.st_ctim);
+#endif
+}
+#endif
+
+#if defined(__linux__) && defined(STATX_TYPE)
+/**
+ * @return t as a struct timespec
+ */
+static struct timespec statxTime(const struct statx_timestamp &t)
+{
+    struct timespec ts;
+    ts.tv_sec = t.tv_sec;
+    ts.tv_nsec = t.tv_nsec;
+    return ts;
+}
+
+/**
+ * Copies the fields statx() says are valid into node
+ */
+static void fromStatx(const struct statx &stx, NodeInfo *node)
+{
+    unsigned    mask = stx.stx_mask;
+
+    if (mask & STATX_TYPE)
+        node->setType(modeType(stx.stx_mode));
+    if (mask & STATX_MODE)
+        node->setMode(stx.stx_mode & ~S_IFMT);
+    if (mask & STATX_NLINK)
+        node->setNlink(stx.stx_nlink);
+    if (mask & STATX_UID)
+        node->setUid(stx.stx_uid);
+    if (mask & STATX_GID)
+        node->setGid(stx.stx_gid);
+    if (mask & STATX_ATIME)
+        node->setAtime(statxTime(stx.stx_atime));
+    if (mask & STATX_MTIME)
+        node->setMtime(statxTime(stx.stx_mtime));
+    if (mask & STATX_CTIME)
+        node->setCtime(statxTime(stx.stx_ctime));
+    if (mask & STATX_INO)
+        node->setInode(stx.stx_ino);
+    if (mask & STATX_SIZE)
+        node->setSize(stx.stx_size);
+    if (mask & STATX_BLOCKS)
+        node->setBlocks(stx.stx_blocks);
+    if (mask & STATX_BTIME)
+        node->setBtime(statxTime(stx.stx_btime));
+    // Always filled in
+    node->setDev(makedev(stx.stx_dev_major, stx.stx_dev_minor));
+}
+static_assert(NodeInfo::TYPE == STATX_TYPE, "NodeInfo::Field must match statx");
+static_assert(NodeInfo::MODE == STATX_MODE, "NodeInfo::Field must match statx");
+static_assert(NodeInfo::NLINK == STATX_NLINK, "NodeInfo::Field must match statx");
+static_assert(NodeInfo::UID == STATX_UID, "NodeInfo::Field must match statx");
+static_assert(NodeInfo::GID == STATX_GID, "NodeInfo::Field must match statx");
+static_assert(NodeInfo::ATIME == STATX_ATIME, "NodeInfo::Field must match statx");
+static_assert(NodeInfo::MTIME == STATX_MTIME, "NodeInfo::Field must match statx");
+static_assert(NodeInfo::CTIME == STATX_CTIME, "NodeInfo::Field must match statx");
+static_assert(NodeInfo::INODE == STATX_INO, "NodeInfo::Field must match statx");
+static_assert(NodeInfo::SIZE == STATX_SIZE, "NodeInfo::Field must match statx");
+static_assert(NodeInfo::BLOCKS == STATX_BLOCKS, "NodeInfo::Field must match statx");
+static_assert(NodeInfo::BTIME == STATX_BTIME, "NodeInfo::Field must match statx");
+// DEV has no STATX_* bit; statat() masks it off and fromStatx() always sets it
+static_assert((NodeInfo::DEV & (STATX_BASIC_STATS | STATX_BTIME)) == 0,
+              "NodeInfo::DEV must not be a statx bit");
+#endif
+
 /**
  * Gets the basic information about a file and returns
  * a new NodeInfo object (you must delete it).  Throws
  * a PathException if path cannot be accessed.
  *
+ * On Linux this uses statx() and only asks for the fields
+ * needed, so a network or FUSE file system can skip the work
+ * of getting the rest.  Check NodeInfo::has() as the file
+ * system may return more or (for BTIME) less than asked.
+ *
  * @param path The path to look for
+ * @param fields NodeInfo::Field bits for what is needed
+ * @param follow If false, return info about a symbolic link
+ *               rather than what it points to (like lstat())
  * @return Newly created NodeInfo object.
  */
-NodeInfo * SysUnixBase::stat(const std::string & path) const
+NodeInfo * SysUnixBase::stat(const std::string & path, unsigned fields, bool follow) const
 {
 #ifdef PW_SYS_LINUX
-    struct stat     statbuf;
-    NodeInfo *node = 0;
-    NodeInfo::Type type = NodeInfo::OTHER;
+    return statat(AT_FDCWD, path.c_str(), fields, follow);
+#else
+    throw Unimplemented ("SysUnixBase::stat");
+#endif
+}
 
-    if (::stat(path.c_str(), &statbuf) < 0)
-        throwException(path, errno);
-    node = new NodeInfo();
+/**
+ * Same as stat() but name is relative to dirfd.  Passing
+ * AT_FDCWD for dirfd makes this the same as stat().
+ *
+ * @param dirfd From opendir() or opendirat()
+ * @param name The file in dirfd
+ * @param fields NodeInfo::Field bits for what is needed
+ * @param follow If false, return info about a symbolic link
+ * @return Newly created NodeInfo object.
+ */
+NodeInfo * SysUnixBase::statat(int dirfd, const char *name, unsigned fields, bool follow) const
+{
+#ifdef PW_SYS_LINUX
+    NodeInfo *node = 0;
+#if defined(__linux__) && defined(STATX_TYPE)
+    struct statx    stx;
+    int flags = AT_STATX_SYNC_AS_STAT | (follow ? 0 : AT_SYMLINK_NOFOLLOW);
 
-    node->setSize(statbuf.st_size);
-    switch (statbuf.st_mode & S_IFMT) {
-    case S_IFDIR:
-        type = NodeInfo::DIRECTORY;
-        break;
-    case S_IFREG:
-        type = NodeInfo::FILE;
-        break;
-    case S_IFLNK:
-        type = NodeInfo::SYMLINK;
-        break;
-    case S_IFCHR:
-    case S_IFBLK:
-        type = NodeInfo::DEVICE;
-        break;
-    default:
-        type = NodeInfo::OTHER;
-        break;
+    // NodeInfo::Field matches the STATX_* bits; DEV is always returned
+    if (::statx(dirfd, name, flags,
+                fields & (STATX_BASIC_STATS | STATX_BTIME), &stx) == 0)
+    {
+        node = new NodeInfo();
+        fromStatx(stx, node);
+        return node;
     }
-    node->setType(type);
+    if (errno != ENOSYS)
+        throwException(name, errno);
+#endif
+    struct stat     statbuf;
+
+    if (::fstatat(dirfd, name, &statbuf, follow ? 0 : AT_SYMLINK_NOFOLLOW) < 0)
+        throwException(name, errno);
+    node = new NodeInfo();
+    fromStat(statbuf, node);
     return node;
 #else
-    throw Unimplemented ("SysUnixBase::stat");
+    throw Unimplemented ("SysUnixBase::statat");
+#endif
+}
+
+/**
+ * @param dirfd From opendir() or opendirat()
+ * @param name The file or directory in dirfd
+ * @param dir True to remove an empty directory, false for a file
+ */
+void SysUnixBase::removeat(int dirfd, const char *name, bool dir) const
+{
+#ifdef PW_SYS_LINUX
+    if (::unlinkat(dirfd, name, dir ? AT_REMOVEDIR : 0) < 0)
+        throwException(name, errno);
+#else
+    throw Unimplemented ("SysUnixBase::removeat");
 #endif
 }
 
@@ -110,10 +110,15 @@ Strings SysWin32::listdir(const std::string &path) const
  * a new NodeInfo object (you must delete it).  Throws
  * a PathException if path cannot be accessed.
  *
+ * Windows has no symbolic links to follow and ::stat() always
+ * returns everything, so fields and follow are ignored.
+ *
  * @param path The path to look for
+ * @param fields NodeInfo::Field bits for what is needed
+ * @param follow If false, return info about a symbolic link
  * @return Newly created NodeInfo object.
  */
-NodeInfo * SysWin32::stat(const std::string & path) const
+NodeInfo * SysWin32::stat(const std::string & path, unsigned, bool) const
 {
 #ifdef __WINNT__
     struct stat     statbuf;
@@ -0,0 +1,106 @@
+/**
+ * @file WalkQueue.cpp
+ */
+#include <path/WalkQueue.h>
+
+#include <utility>
+
+namespace path
+{
+/**
+ * @param capacity Most entries to hold before push() waits
+ */
+WalkQueue::WalkQueue(size_t capacity)
+    : m_ring(capacity ? capacity : 1),
+      m_head(0),
+      m_count(0),
+      m_closed(false),
+      m_mutex(),
+      m_notEmpty(),
+      m_notFull()
+{
+}
+
+WalkQueue::~WalkQueue()
+{
+}
+
+/**
+ * Waits until there is room or the queue is closed.
+ *
+ * @param path The entry to add
+ * @param type Its type if known
+ * @return false if the queue was closed and path was not added
+ */
+bool WalkQueue::push(const Path &path, NodeInfo::Type type)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (m_count == m_ring.size() && !m_closed)
+        m_notFull.wait(lock);
+    if (m_closed)
+        return false;
+    Entry &e = m_ring[(m_head + m_count) % m_ring.size()];
+    e.m_path = path;
+    e.m_type = type;
+    ++m_count;
+    lock.unlock();
+    m_notEmpty.notify_one();
+    return true;
+}
+
+/**
+ * Waits until there is an entry or the queue is closed.
+ *
+ * @param path Set to the entry removed
+ * @param type If not null, set to its type
+ * @return false if the queue is closed and empty
+ */
+bool WalkQueue::pop(Path &path, NodeInfo::Type *type)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (m_count == 0 && !m_closed)
+        m_notEmpty.wait(lock);
+    if (m_count == 0)
+        return false;
+    Entry &e = m_ring[m_head];
+    path = std::move(e.m_path);
+    e.m_path = Path();
+    if (type)
+        *type = e.m_type;
+    m_head = (m_head + 1) % m_ring.size();
+    --m_count;
+    lock.unlock();
+    m_notFull.notify_one();
+    return true;
+}
+
+/**
+ * Wakes up everything waiting in push() or pop().
+ */
+void WalkQueue::close()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_closed = true;
+    }
+    m_notEmpty.notify_all();
+    m_notFull.notify_all();
+}
+
+bool WalkQueue::closed() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_closed;
+}
+
+size_t WalkQueue::size() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_count;
+}
+
+size_t WalkQueue::capacity() const
+{
+    return m_ring.size();
+}
+}
@@ -0,0 +1,89 @@
+/**
+ * @file Benchmark.h
+ * @ingroup PathBenchmark
+ */
+#ifndef _PATH_BENCHMARK_H_
+#define _PATH_BENCHMARK_H_
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace bench {
+/// Number of calls to operator new since the program started
+size_t allocations();
+/// Number of bytes currently allocated by operator new
+size_t allocatedBytes();
+/// Largest value of allocatedBytes() since resetPeak()
+size_t peakBytes();
+/// Start tracking peakBytes() from the current allocatedBytes()
+void resetPeak();
+/// Print one line of results
+void report(const std::string &label, size_t iterations, double nanoseconds,
+            size_t allocs, size_t peak);
+
+/**
+ * Keep the compiler from optimizing away a value.
+ *
+ * @param value The value that must be computed
+ */
+template<typename Type>
+inline void keep(const Type &value)
+{
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+/**
+ * Calls func() iterations times and reports the time, number of
+ * allocations and peak memory for each call.
+ *
+ * @param label Describes what is being measured
+ * @param iterations How many times to call func
+ * @param func The code to measure
+ */
+template<typename Func>
+void measure(const std::string &label, size_t iterations, Func func)
+{
+    size_t  allocs = allocations();
+    size_t  base = allocatedBytes();
+    resetPeak();
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i)
+        func();
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    double  ns = std::chrono::duration<double, std::nano>(end - start).count();
+    report(label, iterations, ns, allocations() - allocs, peakBytes() - base);
+}
+
+/**
+ * @class Benchmark Benchmark.h
+ * Registers a benchmark function so main() can run it by name.
+ * Use the BENCHMARK() macro instead of creating these directly.
+ */
+class Benchmark
+{
+public:
+    /// The function that runs the benchmark
+    typedef void (*Function)();
+    /// Register func with name
+    Benchmark(const char *name, Function func);
+    /// Return all registered benchmarks
+    static std::vector<Benchmark *> &all();
+    /// Name of the benchmark
+    const char *name() const;
+    /// Run the benchmark
+    void run() const;
+private:
+    const char *    m_name;     ///< Name used to select it
+    Function        m_func;     ///< Runs the benchmark
+};
+}
+
+/// Define and register a benchmark function
+#define BENCHMARK(name)                                         \
+    static void name();                                         \
+    static bench::Benchmark s_benchmark_##name(#name, name);    \
+    static void name()
+
+#endif /* _PATH_BENCHMARK_H_ */
@@ -0,0 +1,167 @@
+/**
+ * @file GlobBench.cpp
+ * @ingroup PathBenchmark
+ *
+ * Compares Glob::match() with fnmatch(3) on file names like
+ * those found in a source tree and a GlobSet with trying
+ * each of its patterns on its own.
+ */
+#include "Benchmark.h"
+
+#include <path/Glob.h>
+#include <path/GlobSet.h>
+
+#include <fnmatch.h>
+#include <string>
+#include <vector>
+
+using namespace path;
+
+namespace {
+/// Names of the sort a pattern is usually matched against
+std::vector<std::string> sourceNames()
+{
+    const char  *stems[] = { "PathIter", "main", "Canonical_test", "README", "a_rather_long_module_name" };
+    const char  *exts[] = { ".cpp", ".h", ".o", ".md", "", ".tar.gz", ".c" };
+    std::vector<std::string> names;
+    for (int n = 0; n < 20; ++n)
+    {
+        for (size_t s = 0; s < sizeof(stems) / sizeof(stems[0]); ++s)
+        {
+            for (size_t e = 0; e < sizeof(exts) / sizeof(exts[0]); ++e)
+                names.push_back(stems[s] + std::to_string(n) + exts[e]);
+        }
+    }
+    return names;
+}
+
+/// Compiles patterns into a GlobSet and matches names with it and with each Glob
+void compareSet(const std::string &label, const std::vector<std::string> &patterns,
+                const std::vector<std::string> &names)
+{
+    std::vector<Glob>   globs;
+    GlobSet             set;
+    for (size_t p = 0; p < patterns.size(); ++p)
+    {
+        globs.push_back(Glob(patterns[p]));
+        set.add(patterns[p]);
+    }
+    bench::measure(label + ": compile GlobSet", 3, [&]() {
+        GlobSet copy;
+        for (size_t p = 0; p < patterns.size(); ++p)
+            copy.add(patterns[p]);
+        copy.compile();
+        bench::keep(copy);
+    });
+    set.compile();
+    bench::measure(label + ": each Glob", 3, [&]() {
+        size_t  count = 0;
+        for (size_t i = 0; i < names.size(); ++i)
+        {
+            for (size_t g = 0; g < globs.size(); ++g)
+            {
+                if (globs[g].match(names[i]))
+                {
+                    ++count;
+                    break;
+                }
+            }
+        }
+        bench::keep(count);
+    });
+    bench::measure(label + ": GlobSet", 3, [&]() {
+        size_t  count = 0;
+        for (size_t i = 0; i < names.size(); ++i)
+            count += set.match(names[i]);
+        bench::keep(count);
+    });
+    std::vector<size_t> which;
+    bench::measure(label + ": GlobSet which", 3, [&]() {
+        size_t  count = 0;
+        for (size_t i = 0; i < names.size(); ++i)
+        {
+            which.clear();
+            count += set.match(names[i], which);
+        }
+        bench::keep(count);
+    });
+}
+}
+
+BENCHMARK(glob_vs_fnmatch)
+{
+    std::vector<std::string> names = sourceNames();
+    const char  *patterns[] = { "*.cpp", "*[0-9].[ch]", "*_*_*.o", "*.tar.gz", "[!a-z]*" };
+    for (size_t p = 0; p < sizeof(patterns) / sizeof(patterns[0]); ++p)
+    {
+        Glob        glob(patterns[p]);
+        std::string label(patterns[p]);
+        bench::measure(label + ": fnmatch", 200, [&]() {
+            size_t  count = 0;
+            for (size_t i = 0; i < names.size(); ++i)
+                count += fnmatch(patterns[p], names[i].c_str(), 0) == 0;
+            bench::keep(count);
+        });
+        bench::measure(label + ": Glob", 200, [&]() {
+            size_t  count = 0;
+            for (size_t i = 0; i < names.size(); ++i)
+                count += glob.match(names[i]);
+            bench::keep(count);
+        });
+    }
+    bench::measure("compile {a,b{1,2},*.[ch]}x", 1000, [&]() {
+        Glob    g("{a,b{1,2},*.[ch]}x");
+        bench::keep(g);
+    });
+}
+
+BENCHMARK(glob_literals)
+{
+    // Patterns with a literal part that almost every name fails
+    std::vector<std::string> names = sourceNames();
+    const char  *patterns[] = { "*.log", "core.*", "*_backup_*", "^*.log" };
+    for (size_t p = 0; p < sizeof(patterns) / sizeof(patterns[0]); ++p)
+    {
+        Glob    glob(patterns[p]);
+        bench::measure(patterns[p], 500, [&]() {
+            size_t  count = 0;
+            for (size_t i = 0; i < names.size(); ++i)
+                count += glob.match(names[i]);
+            bench::keep(count);
+        });
+    }
+}
+
+BENCHMARK(globset_vs_globs)
+{
+    std::vector<std::string> names = sourceNames();
+    // Like a large ignore file: suffixes, prefixes and a few alternatives
+    std::vector<std::string> patterns;
+    for (int n = 0; n < 3000; ++n)
+    {
+        std::string num = std::to_string(n);
+        switch (n % 4)
+        {
+        case 0: patterns.push_back("*.ext" + num); break;
+        case 1: patterns.push_back("gen" + num + "_*"); break;
+        case 2: patterns.push_back("mod" + num + ".{c,h,o}"); break;
+        default: patterns.push_back("*" + num + "[a-z].tmp"); break;
+        }
+    }
+    patterns.push_back("*.tar.gz");
+    compareSet("mix", patterns, names);
+
+    // Patterns that match anywhere in the name; once one of them
+    // has matched, stay matched whatever follows
+    std::vector<std::string> infix;
+    for (int n = 0; n < 3000; ++n)
+        infix.push_back("*_backup" + std::to_string(n) + "_*");
+    for (int n = 0; n < 100; ++n)
+        names.push_back("db_backup" + std::to_string(n * 37) + "_2024.sql");
+    compareSet("infix", infix, names);
+
+    // A fifth of them like that
+    for (size_t p = 0; p < patterns.size(); p += 5)
+        patterns[p] = "*_backup" + std::to_string(p) + "_*";
+    compareSet("20% infix", patterns, names);
+}
@@ -0,0 +1,91 @@
+/**
+ * @file MoveBench.cpp
+ * @ingroup PathBenchmark
+ *
+ * Compares copying and moving Path, Canonical and PathIter.
+ */
+#include "Benchmark.h"
+
+#include <path/Path.h>
+#include <path/PathIter.h>
+#include <path/Canonical.h>
+#include <path/SysBase.h>
+
+#include <utility>
+
+using namespace path;
+
+BENCHMARK(canonical_copy_vs_move)
+{
+    const Canonical orig(UnixPath("/usr/local/share/some_application/resources/images/icons"));
+
+    bench::measure("Canonical copy", 100000, [&]() {
+        Canonical c(orig);
+        Canonical d(c);
+        bench::keep(d);
+    });
+    bench::measure("Canonical move", 100000, [&]() {
+        Canonical c(orig);
+        Canonical d(std::move(c));
+        bench::keep(d);
+    });
+}
+
+BENCHMARK(path_push_back_copy_vs_move)
+{
+    const Path  orig(UnixPath("/usr/local/share/some_application"));
+    Paths       paths;
+    paths.reserve(100000);
+
+    bench::measure("push_back(p)", 100000, [&]() {
+        Path p(orig);
+        paths.push_back(p);
+    });
+    paths.clear();
+    bench::measure("push_back(std::move(p))", 100000, [&]() {
+        Path p(orig);
+        paths.push_back(std::move(p));
+    });
+}
+
+BENCHMARK(path_add_copy_vs_move)
+{
+    const Path  dir(UnixPath("/usr/local/share/some_application"));
+    const std::string name("a_file_name_longer_than_sso.txt");
+
+    bench::measure("add(const std::string &)", 100000, [&]() {
+        std::string n(name);
+        Path p = dir.add(n);
+        bench::keep(p);
+    });
+    bench::measure("add(std::string &&)", 100000, [&]() {
+        std::string n(name);
+        Path p = dir.add(std::move(n));
+        bench::keep(p);
+    });
+}
+
+BENCHMARK(pathiter_copy_vs_move)
+{
+    Path        dir(UnixPath("benchmark_tmp"));
+    const int   files = 200;
+
+    System.mkdir(dir.path());
+    for (int i = 0; i < files; ++i)
+        System.touch((dir / std::to_string(i)).path());
+
+    PathIter    orig(dir);
+    bench::measure("PathIter copy", 1000, [&]() {
+        PathIter iter(orig);
+        bench::keep(iter);
+    });
+    bench::measure("PathIter move", 1000, [&]() {
+        PathIter iter(orig);
+        PathIter moved(std::move(iter));
+        bench::keep(moved);
+    });
+
+    for (int i = 0; i < files; ++i)
+        System.remove((dir / std::to_string(i)).path());
+    System.rmdir(dir.path());
+}
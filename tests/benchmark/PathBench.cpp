@@ -0,0 +1,124 @@
+/**
+ * @file PathBench.cpp
+ * @ingroup PathBenchmark
+ *
+ * Measures creating Paths and converting them back to strings.
+ */
+#include "Benchmark.h"
+
+#include <path/Path.h>
+#include <path/Canonical.h>
+#include <path/PathSet.h>
+
+#include <map>
+#include <string>
+#include <unordered_map>
+
+using namespace path;
+
+BENCHMARK(path_from_string)
+{
+    const std::string   str("/usr/local/share/some_application/resources/icon.png");
+    const Path          shared(UnixPath("/usr/local/share/some_application/resources/icon.png"));
+
+    bench::measure("Path(string)", 100000, [&]() {
+        Path p(str);
+        bench::keep(p);
+    });
+    bench::measure("Path(string).path()", 100000, [&]() {
+        Path p(str);
+        bench::keep(p.path());
+    });
+    bench::measure("Path(UnixPath(string)).path()", 100000, [&]() {
+        Path p(UnixPath(str));
+        bench::keep(p.path());
+    });
+    bench::measure("Path(string).basename()", 100000, [&]() {
+        Path p(str);
+        bench::keep(p.basename());
+    });
+    shared.path();
+    bench::measure("path() on an existing Path", 100000, [&]() {
+        bench::keep(shared.path());
+    });
+}
+
+BENCHMARK(path_lookup)
+{
+    const int   count = 10000;
+    Path        root = Path(UnixPath("/usr/local/share/some_application")).makeShared();
+    Paths       keys;
+    Paths       probes;
+    for (int i = 0; i < count; ++i)
+    {
+        keys.push_back(root / ("dir" + std::to_string(i % 100)) / ("file" + std::to_string(i)));
+        // A different Path object equal to the key
+        probes.push_back(Path(keys.back().canon()));
+    }
+
+    std::map<Path, int>             map;
+    std::unordered_map<Path, int>   umap;
+    PathMap<int>                    pmap;
+    for (int i = 0; i < count; ++i)
+    {
+        map[keys[i]] = i;
+        umap[keys[i]] = i;
+        pmap[keys[i]] = i;
+    }
+
+    size_t  index = 0;
+    bench::measure("std::map<Path>::find", 100000, [&]() {
+        bench::keep(map.find(probes[index++ % count]));
+    });
+    index = 0;
+    bench::measure("std::unordered_map<Path>::find", 100000, [&]() {
+        bench::keep(umap.find(probes[index++ % count]));
+    });
+    index = 0;
+    bench::measure("PathMap::find", 100000, [&]() {
+        bench::keep(pmap.find(probes[index++ % count]));
+    });
+}
+
+BENCHMARK(path_append)
+{
+    const Path          dir(UnixPath("/usr/local/share/some_application"));
+    const Path          shared = dir.makeShared();
+    const char *        name = "a_file_name_longer_than_sso.txt";
+    const std::string   str(name);
+    const std::string_view view(str);
+
+    bench::measure("dir / const char *", 100000, [&]() {
+        bench::keep(dir / name);
+    });
+    bench::measure("dir / std::string_view", 100000, [&]() {
+        bench::keep(dir / view);
+    });
+    bench::measure("shared / const char *", 100000, [&]() {
+        bench::keep(shared / name);
+    });
+    bench::measure("shared / std::string_view", 100000, [&]() {
+        bench::keep(shared / view);
+    });
+    bench::measure("shared / std::string", 100000, [&]() {
+        bench::keep(shared / str);
+    });
+    bench::measure("RulesBase::canonical(view)", 100000, [&]() {
+        bench::keep(Path::defaultRulesBase()->canonical(view));
+    });
+}
+
+BENCHMARK(rules_str)
+{
+    const RulesBase *   rules = Path::defaultRulesBase();
+    const Canonical     parsed = rules->canonical("/usr/local/share/some_application/resources/icon.png");
+    Canonical           unknown(parsed);
+    unknown.setPlain(0);
+
+    bench::measure("str(canon) parsed by the rules", 100000, [&]() {
+        bench::keep(rules->str(parsed));
+    });
+    bench::measure("str(canon) that must be checked", 100000, [&]() {
+        bench::keep(rules->str(unknown));
+    });
+}
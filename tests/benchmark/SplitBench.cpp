@@ -0,0 +1,139 @@
+/**
+ * @file SplitBench.cpp
+ * @ingroup PathBenchmark
+ *
+ * Compares path::split() and RulesBase::canonical() with the
+ * previous find_first_of()/erase() versions on a few kinds of paths.
+ */
+#include "Benchmark.h"
+
+#include <path/Strings.h>
+#include <path/Canonical.h>
+#include <path/RulesUnix.h>
+
+#include <string>
+
+using namespace path;
+
+namespace {
+/// The split() from before Splitter was used
+void oldSplit(const std::string &word, char sep, Strings &strings)
+{
+    std::string::size_type  start = 0;
+    std::string::size_type  end = 0;
+
+    while (start < word.size() && end != std::string::npos)
+    {
+        end = word.find_first_of(sep, start);
+        strings.push_back(word.substr(start, end - start));
+        if (end == word.size() - 1)
+            strings.push_back(std::string(""));
+        start = end + 1;
+    }
+}
+
+/// The RulesBase::canonical() from before Splitter was used
+Canonical oldCanonical(const std::string &path, char sep)
+{
+    Canonical       canon;
+    Strings         components;
+    bool            first = true;
+
+    oldSplit(path, sep, components);
+    Strings::iterator iter = components.begin();
+    while (iter != components.end())
+    {
+        if (iter->empty())
+        {
+            if (first)
+                canon.setAbs(true);
+            iter = components.erase(iter);
+        }
+        else
+            ++iter;
+        first = false;
+    }
+    canon.components().swap(components);
+    return canon;
+}
+
+/// Paths like those found under /usr
+Strings systemPaths()
+{
+    const char *dirs[] = { "/usr/include/c++/12/bits/", "/usr/lib/x86_64-linux-gnu/",
+                           "/usr/share/doc/", "/home/user/src/project/build/" };
+    Strings paths;
+    for (int i = 0; i < 1000; ++i)
+        paths.push_back(std::string(dirs[i % 4]) + "file_" + std::to_string(i) + ".h");
+    return paths;
+}
+
+/// Deep paths with long component names
+Strings deepPaths()
+{
+    Strings paths;
+    for (int i = 0; i < 1000; ++i)
+    {
+        std::string p;
+        for (int depth = 0; depth < 12; ++depth)
+            p += "/a_rather_long_directory_name_" + std::to_string((i + depth) % 7);
+        paths.push_back(p);
+    }
+    return paths;
+}
+
+/// Paths with many doubled separators
+Strings sloppyPaths()
+{
+    Strings paths;
+    for (int i = 0; i < 1000; ++i)
+    {
+        std::string p;
+        for (int depth = 0; depth < 20; ++depth)
+            p += "//d" + std::to_string(depth);
+        paths.push_back(p + "//");
+    }
+    return paths;
+}
+
+void compare(const std::string &corpus, const Strings &paths)
+{
+    size_t  index = 0;
+    Strings components;
+    bench::measure(corpus + ": old split", 100000, [&]() {
+        components.clear();
+        oldSplit(paths[index++ % paths.size()], '/', components);
+        bench::keep(components);
+    });
+    index = 0;
+    bench::measure(corpus + ": split", 100000, [&]() {
+        components.clear();
+        split(paths[index++ % paths.size()], '/', components);
+        bench::keep(components);
+    });
+    index = 0;
+    bench::measure(corpus + ": old canonical", 100000, [&]() {
+        bench::keep(oldCanonical(paths[index++ % paths.size()], '/'));
+    });
+    index = 0;
+    bench::measure(corpus + ": canonical", 100000, [&]() {
+        bench::keep(RulesUnix::rules.canonical(paths[index++ % paths.size()]));
+    });
+    index = 0;
+    bench::measure(corpus + ": Splitter only", 100000, [&]() {
+        Splitter            splitter(paths[index++ % paths.size()], '/');
+        std::string_view    component;
+        size_t              count = 0;
+        while (splitter.next(component))
+            count += component.size();
+        bench::keep(count);
+    });
+}
+}
+
+BENCHMARK(split_paths)
+{
+    compare("system", systemPaths());
+    compare("deep", deepPaths());
+    compare("sloppy", sloppyPaths());
+}
@@ -0,0 +1,305 @@
+/**
+ * @file WalkBench.cpp
+ * @ingroup PathBenchmark
+ *
+ * Walks a deep directory tree recursively with PathIter, both by
+ * full path and relative to the open parent directory, and with
+ * ParallelWalker using more and more threads.  Compares the
+ * PathIter traversal orders on wide and deep trees and the ways
+ * of sorting a large directory, and asking each entry if it is
+ * a directory.  Compares Path::glob() with walking everything
+ * and matching each Path, and a PathIter given a pattern with
+ * checking the name of every entry.  Also copies
+ * iterators part way through a wide directory the way the
+ * standard algorithms do.
+ */
+#include "Benchmark.h"
+
+#include <path/Path.h>
+#include <path/PathIter.h>
+#include <path/ParallelWalker.h>
+#include <path/SysBase.h>
+#include <path/DirEntries.h>
+#include <path/Glob.h>
+
+#include <stdlib.h>
+#include <algorithm>
+#include <atomic>
+#include <string>
+
+using namespace path;
+
+namespace {
+/**
+ * Creates depth levels of directories, each with width
+ * subdirectories and files regular files.
+ */
+void makeTree(const Path &dir, int depth, int width, int files)
+{
+    for (int i = 0; i < files; ++i)
+        System.touch(dir.add("file_" + std::to_string(i)).path());
+    if (depth == 0)
+        return;
+    for (int i = 0; i < width; ++i)
+    {
+        Path    sub = dir.add("a_rather_long_directory_name_" + std::to_string(i));
+        System.mkdir(sub.path());
+        makeTree(sub, depth - 1, width, files);
+    }
+}
+
+/// Removes everything makeTree() created
+void removeTree(const Path &dir)
+{
+    Strings names = System.listdir(dir.path());
+    for (Strings::const_iterator iter = names.begin(); iter != names.end(); ++iter)
+    {
+        Path    p = dir.add(*iter);
+        if (p.isDir())
+            removeTree(p);
+        else
+            System.remove(p.path());
+    }
+    System.rmdir(dir.path());
+}
+
+/// Count everything below top
+size_t walk(const Path &top, bool relative,
+            PathIter::TraversalOrder order = PathIter::DEPTH_FIRST)
+{
+    size_t      count = 0;
+    PathIter    iter(top);
+    PathIter    end;
+    if (relative)
+        iter.setRelative();
+    for (iter.setRecursive(order); iter != end; ++iter)
+        ++count;
+    return count;
+}
+}
+
+BENCHMARK(walk_by_path_vs_relative)
+{
+    char    temp[] = "/tmp/walkbenchXXXXXX";
+    if (!mkdtemp(temp))
+        return;
+    Path    top(temp);
+    // 2^9 directories 9 deep, 4 files in each
+    makeTree(top, 9, 2, 4);
+
+    bench::measure("PathIter by path", 5, [&]() {
+        bench::keep(walk(top, false));
+    });
+    bench::measure("PathIter setRelative()", 5, [&]() {
+        bench::keep(walk(top, true));
+    });
+    removeTree(top);
+}
+
+BENCHMARK(parallel_walker_threads)
+{
+    char    temp[] = "/tmp/walkbenchXXXXXX";
+    if (!mkdtemp(temp))
+        return;
+    Path    top(temp);
+    makeTree(top, 9, 2, 4);
+
+    bench::measure("PathIter", 5, [&]() {
+        bench::keep(walk(top, false));
+    });
+    for (unsigned threads = 1; threads <= 8; threads *= 2)
+    {
+        ParallelWalker  walker(threads);
+        bench::measure("ParallelWalker " + std::to_string(threads) + " threads", 5, [&]() {
+            std::atomic<size_t> count(0);
+            walker.walk(top, [&count](const Path &, NodeInfo::Type) {
+                ++count;
+            });
+            bench::keep(count);
+        });
+    }
+    removeTree(top);
+}
+
+BENCHMARK(walk_is_dir)
+{
+    char    temp[] = "/tmp/walkbenchXXXXXX";
+    if (!mkdtemp(temp))
+        return;
+    Path    top(temp);
+    makeTree(top, 9, 2, 4);
+
+    bench::measure("count directories", 5, [&]() {
+        size_t      dirs = 0;
+        PathIter    end;
+        for (PathIter iter = PathIter(top).setRecursive(); iter != end; ++iter)
+        {
+            if (iter->isDir())
+                ++dirs;
+        }
+        bench::keep(dirs);
+    });
+    removeTree(top);
+}
+
+BENCHMARK(traversal_orders)
+{
+    char    wide[] = "/tmp/walkbenchXXXXXX";
+    char    deep[] = "/tmp/walkbenchXXXXXX";
+    if (!mkdtemp(wide) || !mkdtemp(deep))
+        return;
+    // 1885 directories 3 deep, 4 files in each
+    makeTree(Path(wide), 3, 12, 4);
+    // 40 directories one inside the other, 50 files in each
+    makeTree(Path(deep), 40, 1, 50);
+
+    const char *names[] = { "depth first", "breadth first", "in order" };
+    const PathIter::TraversalOrder orders[] = {
+        PathIter::DEPTH_FIRST, PathIter::BREADTH_FIRST, PathIter::IN_ORDER
+    };
+    for (size_t i = 0; i < 3; ++i)
+    {
+        bench::measure(std::string("wide: ") + names[i], 5, [&]() {
+            bench::keep(walk(Path(wide), true, orders[i]));
+        });
+    }
+    for (size_t i = 0; i < 3; ++i)
+    {
+        bench::measure(std::string("deep: ") + names[i], 5, [&]() {
+            bench::keep(walk(Path(deep), true, orders[i]));
+        });
+    }
+    removeTree(Path(wide));
+    removeTree(Path(deep));
+}
+
+BENCHMARK(glob_components)
+{
+    char    temp[] = "/tmp/walkbenchXXXXXX";
+    if (!mkdtemp(temp))
+        return;
+    // 1885 directories 3 deep, 4 files in each
+    Path    top(temp);
+    makeTree(top, 3, 12, 4);
+    std::string dir("a_rather_long_directory_name_");
+    std::string pattern = dir + "3/*/" + dir + "7/file_[12]";
+
+    bench::measure("walk everything and match", 5, [&]() {
+        Glob        glob(top.str() + "/" + pattern);
+        size_t      count = 0;
+        PathIter    end;
+        for (PathIter iter = PathIter(top).setRecursive(); iter != end; ++iter)
+            count += glob.match(iter->str());
+        bench::keep(count);
+    });
+    bench::measure("glob()", 5, [&]() {
+        size_t      count = 0;
+        for (PathIter iter = top.glob(pattern); iter != top.end(); ++iter)
+            ++count;
+        bench::keep(count);
+    });
+    bench::measure("walk everything for a name", 5, [&]() {
+        size_t      count = 0;
+        PathIter    end;
+        for (PathIter iter = PathIter(top).setRecursive(); iter != end; ++iter)
+            count += iter->basename() == "file_1";
+        bench::keep(count);
+    });
+    bench::measure("glob() **/file_1", 5, [&]() {
+        size_t      count = 0;
+        for (PathIter iter = top.glob("**/file_1"); iter != top.end(); ++iter)
+            ++count;
+        bench::keep(count);
+    });
+    removeTree(top);
+}
+
+BENCHMARK(iter_pattern)
+{
+    char    temp[] = "/tmp/walkbenchXXXXXX";
+    if (!mkdtemp(temp))
+        return;
+    // 157 directories 2 deep, 100 files in each
+    Path    top(temp);
+    makeTree(top, 2, 12, 100);
+
+    bench::measure("walk everything and match", 5, [&]() {
+        Glob        glob("file_?7");
+        size_t      count = 0;
+        PathIter    end;
+        for (PathIter iter = PathIter(top).setRecursive(); iter != end; ++iter)
+            count += glob.match(iter->basename());
+        bench::keep(count);
+    });
+    bench::measure("PathIter(top, \"file_?7\")", 5, [&]() {
+        size_t      count = 0;
+        PathIter    end;
+        for (PathIter iter = PathIter(top, "file_?7", false).setRecursive(); iter != end; ++iter)
+            ++count;
+        bench::keep(count);
+    });
+    bench::measure("PathIter(top, \"^file_.7$\", true)", 5, [&]() {
+        size_t      count = 0;
+        PathIter    end;
+        for (PathIter iter = PathIter(top, "^file_.7$", true).setRecursive(); iter != end; ++iter)
+            ++count;
+        bench::keep(count);
+    });
+    removeTree(top);
+}
+
+BENCHMARK(directory_sort)
+{
+    // Like a mail spool: 100000 names in no particular order
+    DirEntries  entries;
+    for (unsigned i = 0; i < 100000; ++i)
+    {
+        unsigned    n = i * 2654435761u;
+        entries.add(std::to_string(n % 1000000000) + ".M" + std::to_string(n % 997) + "P1234.host",
+                    NodeInfo::FILE, i);
+    }
+    std::vector<size_t> order;
+    bench::measure("std::sort", 5, [&]() {
+        order.resize(entries.size());
+        for (size_t i = 0; i < order.size(); ++i)
+            order[i] = i;
+        std::sort(order.begin(), order.end(), [&entries](size_t a, size_t b) {
+            return entries[a].name < entries[b].name;
+        });
+        bench::keep(order[0]);
+    });
+    const char *names[] = { "unsorted", "bytewise radix", "natural" };
+    const DirEntries::SortOrder how[] = {
+        DirEntries::UNSORTED, DirEntries::BYTEWISE, DirEntries::NATURAL
+    };
+    for (size_t i = 0; i < 3; ++i)
+    {
+        bench::measure(names[i], 5, [&]() {
+            entries.sort(order, how[i]);
+            bench::keep(order[0]);
+        });
+    }
+}
+
+BENCHMARK(iterator_copies)
+{
+    char    temp[] = "/tmp/walkbenchXXXXXX";
+    if (!mkdtemp(temp))
+        return;
+    Path    top(temp);
+    // One directory of 2000 files
+    makeTree(top, 0, 0, 2000);
+
+    PathIter    iter(top);
+    PathIter    end;
+    for (int i = 0; i < 1000; ++i)
+        ++iter;
+    bench::measure("copy", 1000, [&]() {
+        PathIter    copy(iter);
+        bench::keep(copy == iter);
+    });
+    bench::measure("std::distance", 100, [&]() {
+        bench::keep(std::distance(iter, end));
+    });
+    removeTree(top);
+}
@@ -0,0 +1,125 @@
+/**
+ * @file benchmark/main.cpp
+ * @defgroup PathBenchmark Benchmarks for the path library
+ *
+ * Each benchmark reports the time, number of allocations and
+ * peak memory per iteration.  Run with no arguments to run
+ * them all or give the names (or part of the names) of the
+ * ones to run.
+ */
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+namespace {
+/// Kept in front of every allocation so operator delete knows the size
+const size_t s_header = 16;
+size_t  s_allocations;
+size_t  s_bytes;
+size_t  s_peak;
+
+void *allocate(size_t size)
+{
+    char *p = static_cast<char *>(std::malloc(size + s_header));
+    if (!p)
+        throw std::bad_alloc();
+    *reinterpret_cast<size_t *>(p) = size;
+    ++s_allocations;
+    s_bytes += size;
+    if (s_bytes > s_peak)
+        s_peak = s_bytes;
+    return p + s_header;
+}
+
+void deallocate(void *ptr)
+{
+    if (!ptr)
+        return;
+    char *p = static_cast<char *>(ptr) - s_header;
+    s_bytes -= *reinterpret_cast<size_t *>(p);
+    std::free(p);
+}
+}
+
+void *operator new(size_t size) { return allocate(size); }
+void *operator new[](size_t size) { return allocate(size); }
+void operator delete(void *ptr) noexcept { deallocate(ptr); }
+void operator delete[](void *ptr) noexcept { deallocate(ptr); }
+void operator delete(void *ptr, size_t) noexcept { deallocate(ptr); }
+void operator delete[](void *ptr, size_t) noexcept { deallocate(ptr); }
+
+namespace bench {
+size_t allocations()
+{
+    return s_allocations;
+}
+
+size_t allocatedBytes()
+{
+    return s_bytes;
+}
+
+size_t peakBytes()
+{
+    return s_peak;
+}
+
+void resetPeak()
+{
+    s_peak = s_bytes;
+}
+
+void report(const std::string &label, size_t iterations, double nanoseconds,
+            size_t allocs, size_t peak)
+{
+    std::printf("  %-44s %10.1f ns/op %8.2f allocs/op %10zu peak bytes\n",
+                label.c_str(), nanoseconds / iterations,
+                static_cast<double>(allocs) / iterations, peak);
+}
+
+Benchmark::Benchmark(const char *name, Function func)
+    : m_name(name),
+      m_func(func)
+{
+    all().push_back(this);
+}
+
+std::vector<Benchmark *> &Benchmark::all()
+{
+    static std::vector<Benchmark *> benchmarks;
+    return benchmarks;
+}
+
+const char *Benchmark::name() const
+{
+    return m_name;
+}
+
+void Benchmark::run() const
+{
+    m_func();
+}
+}
+
+int main(int argc, char **argv)
+{
+    std::vector<bench::Benchmark *> &all = bench::Benchmark::all();
+    for (std::vector<bench::Benchmark *>::const_iterator iter = all.begin();
+         iter != all.end(); ++iter)
+    {
+        bool    selected = argc < 2;
+        for (int i = 1; i < argc; ++i)
+        {
+            if (std::strstr((*iter)->name(), argv[i]))
+                selected = true;
+        }
+        if (!selected)
+            continue;
+        std::printf("%s\n", (*iter)->name());
+        (*iter)->run();
+    }
+    return 0;
+}
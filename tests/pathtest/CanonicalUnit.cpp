@@ -7,6 +7,8 @@
 #include <cppunit/TestCase.h>
 #include <cppunit/extensions/HelperMacros.h>
 
+#include <algorithm>
+#include <iterator>
 #include <sstream>
 #include <vector>
 #include <string>
@@ -26,6 +28,8 @@ class CanonicalUnit : public CppUnit::TestCase
     CPPUNIT_TEST(testCompare);
     CPPUNIT_TEST(testAdd);
     CPPUNIT_TEST(testSetInfo);
+    CPPUNIT_TEST(testPacked);
+    CPPUNIT_TEST(testMove);
     
     CPPUNIT_TEST_SUITE_END();
 protected:
@@ -41,6 +45,10 @@ protected:
     void testAdd();
     /// Test the copyInfo() method
     void testSetInfo();
+    /// Test setPacked() and the view() of components
+    void testPacked();
+    /// Test move constructor and assignment
+    void testMove();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(CanonicalUnit);
@@ -191,3 +199,72 @@ void CanonicalUnit::testSetInfo()
     CPPUNIT_ASSERT_EQUAL(c1.host(), c2.host());
     CPPUNIT_ASSERT_EQUAL(std::string("A"), c2.drive());
 }
+
+void CanonicalUnit::testPacked()
+{
+    Canonical   c1("a", "bc", "def");
+    Canonical   c2(c1);
+
+    c2.setPacked(true);
+    CPPUNIT_ASSERT(c2.packed());
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), c2.size());
+    CPPUNIT_ASSERT(c2.view()[1] == "bc");
+    CPPUNIT_ASSERT(c2.view().back() == "def");
+    CPPUNIT_ASSERT_EQUAL(c1, c2);
+
+    // The view's iterators are random access
+    ComponentView   view = c2.view();
+    ComponentView::const_iterator   iter = view.begin();
+    CPPUNIT_ASSERT(iter[2] == "def");
+    CPPUNIT_ASSERT(*(iter + 1) == "bc" && *(1 + iter) == "bc");
+    CPPUNIT_ASSERT(iter < view.end() && view.end() > iter);
+    CPPUNIT_ASSERT_EQUAL(std::ptrdiff_t(3), std::distance(view.begin(), view.end()));
+    std::advance(iter, 3);
+    CPPUNIT_ASSERT(iter == view.end());
+    iter -= 2;
+    CPPUNIT_ASSERT(*iter-- == "bc" && *iter == "a");
+    CPPUNIT_ASSERT(std::lower_bound(view.begin(), view.end(), std::string_view("b")) - view.begin() == 1);
+
+    // Copies stay packed
+    Canonical   c3(c2);
+    c3.add("g").extendLast(".h");
+    CPPUNIT_ASSERT(c3.packed());
+    CPPUNIT_ASSERT(c3.component(3) == "g.h");
+    CPPUNIT_ASSERT(c1 != c3);
+    c3.removeLast();
+    CPPUNIT_ASSERT_EQUAL(c1, c3);
+
+    // const components() leaves it packed
+    const Canonical &cref = c3;
+    CPPUNIT_ASSERT(c1.components() == cref.components());
+    CPPUNIT_ASSERT(c3.packed());
+
+    // Non-const components() unpacks
+    c3.components().push_back("x");
+    CPPUNIT_ASSERT(!c3.packed());
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(4), c3.size());
+    std::ostringstream  out;
+    out << c3;
+    CPPUNIT_ASSERT_EQUAL(std::string("a/bc/def/x/"), out.str());
+}
+
+void CanonicalUnit::testMove()
+{
+    Canonical   c1("a", "b");
+    c1.setDrive("C");
+    Canonical   c2(std::move(c1));
+
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), c2.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("C"), c2.drive());
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), c1.size());
+
+    c2.setPacked(true);
+    c1 = std::move(c2);
+    CPPUNIT_ASSERT(c1.packed());
+    CPPUNIT_ASSERT(c1.component(1) == "b");
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), c2.size());
+
+    std::string dir("c");
+    c2.add(std::move(dir));
+    CPPUNIT_ASSERT(c2.component(0) == "c");
+}
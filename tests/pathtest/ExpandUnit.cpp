@@ -20,6 +20,7 @@ class ExpandUnit : public CppUnit::TestCase
     CPPUNIT_TEST(nested);
     CPPUNIT_TEST(braces);
     CPPUNIT_TEST(split);
+    CPPUNIT_TEST(splitter);
     CPPUNIT_TEST(recurse);
     
     CPPUNIT_TEST_SUITE_END();
@@ -32,6 +33,8 @@ protected:
     void braces();
     /// Test that path::split() works
     void split();
+    /// Test Splitter across the 64 byte blocks it scans
+    void splitter();
 	/// Test that expand var to itself $VAR=$VAR
 	void recurse();
 };
@@ -119,6 +122,45 @@ void ExpandUnit::split()
     CPPUNIT_ASSERT_EQUAL(std::string(""), strings[6]);
 }
 
+void ExpandUnit::splitter()
+{
+    // Separators at every position up to and past several blocks
+    for (size_t len = 0; len < 200; ++len)
+    {
+        for (size_t step = 1; step < 9; ++step)
+        {
+            std::string str;
+            for (size_t i = 0; i < len; ++i)
+                str += (i % step == step - 1) ? '/' : static_cast<char>('a' + i % 26);
+
+            path::Strings expected;
+            std::string::size_type start = 0;
+            while (!str.empty())
+            {
+                std::string::size_type end = str.find('/', start);
+                expected.push_back(str.substr(start, end - start));
+                if (end == std::string::npos)
+                    break;
+                start = end + 1;
+            }
+
+            path::Strings   strings;
+            path::split(str, '/', strings);
+            CPPUNIT_ASSERT(expected == strings);
+        }
+    }
+
+    // Only bytes within the string_view are looked at
+    std::string         str("a/b/c/d");
+    path::Splitter      splitter(std::string_view(str).substr(0, 3), '/');
+    std::string_view    component;
+    CPPUNIT_ASSERT(splitter.next(component));
+    CPPUNIT_ASSERT(component == "a");
+    CPPUNIT_ASSERT(splitter.next(component));
+    CPPUNIT_ASSERT(component == "b");
+    CPPUNIT_ASSERT(!splitter.next(component));
+}
+
 void ExpandUnit::recurse()
 {
     path::StringMap env;
@@ -0,0 +1,254 @@
+/**
+ * @file GlobSetUnit.cpp
+ * @ingroup PathTest
+ */
+#include <path/GlobSet.h>
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <stdlib.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace path;
+/**
+ * Implements unit tests for GlobSet class
+ */
+class GlobSetUnit : public CppUnit::TestCase
+{
+    CPPUNIT_TEST_SUITE(GlobSetUnit);
+
+    CPPUNIT_TEST(init);
+    CPPUNIT_TEST(which);
+    CPPUNIT_TEST(suffixes);
+    CPPUNIT_TEST(many);
+    CPPUNIT_TEST(infix);
+    CPPUNIT_TEST(copy);
+    CPPUNIT_TEST(threads);
+
+    CPPUNIT_TEST_SUITE_END();
+protected:
+    /// Test an empty set and adding patterns
+    void init();
+    /// Test reporting which patterns matched
+    void which();
+    /// Test the "*.ext" patterns
+    void suffixes();
+    /// Compare with one Glob per pattern
+    void many();
+    /// Patterns like "*lit*" that have matched whatever follows
+    void infix();
+    /// Copies outlive the compiled original
+    void copy();
+    /// Match from several threads once compiled
+    void threads();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(GlobSetUnit);
+
+void GlobSetUnit::init()
+{
+    GlobSet set;
+    CPPUNIT_ASSERT(!set.match("a"));
+    CPPUNIT_ASSERT(!set.match(""));
+
+    CPPUNIT_ASSERT(set.add("a*"));
+    CPPUNIT_ASSERT(!set.add("{a,b"));
+    CPPUNIT_ASSERT_EQUAL(size_t(1), set.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("a*"), set.pattern(0));
+    CPPUNIT_ASSERT(set.match("abc"));
+    CPPUNIT_ASSERT(!set.match("b"));
+
+    // Adding after matching compiles again
+    CPPUNIT_ASSERT(set.add("b"));
+    CPPUNIT_ASSERT(set.match("b"));
+}
+
+void GlobSetUnit::which()
+{
+    GlobSet set;
+    set.add("*.o");         // 0
+    set.add("*.[ch]");      // 1
+    set.add("core");        // 2
+    set.add("*");           // 3
+    set.add("^*.c");        // 4
+    set.add("test.{c,h}");  // 5
+
+    std::vector<size_t> which;
+    CPPUNIT_ASSERT_EQUAL(size_t(3), set.match("test.c", which));
+    CPPUNIT_ASSERT_EQUAL(size_t(1), which[0]);
+    CPPUNIT_ASSERT_EQUAL(size_t(3), which[1]);
+    CPPUNIT_ASSERT_EQUAL(size_t(5), which[2]);
+
+    // Indexes are added to what is already there
+    CPPUNIT_ASSERT_EQUAL(size_t(3), set.match("core", which));
+    CPPUNIT_ASSERT_EQUAL(size_t(6), which.size());
+    CPPUNIT_ASSERT_EQUAL(size_t(2), which[3]);
+    CPPUNIT_ASSERT_EQUAL(size_t(3), which[4]);
+    CPPUNIT_ASSERT_EQUAL(size_t(4), which[5]);
+
+    which.clear();
+    CPPUNIT_ASSERT_EQUAL(size_t(3), set.match("x.o", which));
+    CPPUNIT_ASSERT_EQUAL(size_t(0), which[0]);
+}
+
+void GlobSetUnit::suffixes()
+{
+    GlobSet set;
+    set.add("*.gz");        // 0
+    set.add("*.tar.gz");    // 1
+    set.add("*.gz");        // 2
+    set.add("*z");          // 3
+    set.add("*]");          // 4
+
+    std::vector<size_t> which;
+    CPPUNIT_ASSERT_EQUAL(size_t(4), set.match("a.tar.gz", which));
+    CPPUNIT_ASSERT_EQUAL(size_t(0), which[0]);
+    CPPUNIT_ASSERT_EQUAL(size_t(1), which[1]);
+    CPPUNIT_ASSERT_EQUAL(size_t(2), which[2]);
+    CPPUNIT_ASSERT_EQUAL(size_t(3), which[3]);
+
+    which.clear();
+    CPPUNIT_ASSERT_EQUAL(size_t(3), set.match(".gz", which));
+    CPPUNIT_ASSERT_EQUAL(size_t(0), set.match("gz.", which));
+    CPPUNIT_ASSERT(set.match("a]"));
+    CPPUNIT_ASSERT(!set.match("a.g"));
+}
+
+void GlobSetUnit::many()
+{
+    // Enough patterns with several '*' that they need more than one group
+    std::vector<Glob>   globs;
+    GlobSet             set;
+    const char          chars[] = "abc*?.";
+    srand(2);
+    for (int i = 0; i < 100; ++i)
+    {
+        std::string pattern;
+        for (int n = 2 + rand() % 8; n > 0; --n)
+            pattern += chars[rand() % (sizeof(chars) - 1)];
+        if (i % 3 == 0)
+            pattern = "*." + pattern.substr(0, 3);
+        CPPUNIT_ASSERT(set.add(pattern));
+        globs.push_back(Glob(pattern));
+    }
+    std::vector<size_t> which;
+    std::vector<size_t> expected;
+    for (int i = 0; i < 300; ++i)
+    {
+        std::string word;
+        for (int n = rand() % 10; n > 0; --n)
+            word += "abc."[rand() % 4];
+        expected.clear();
+        for (size_t g = 0; g < globs.size(); ++g)
+        {
+            if (globs[g].match(word))
+                expected.push_back(g);
+        }
+        which.clear();
+        set.match(word, which);
+        CPPUNIT_ASSERT(expected == which);
+        CPPUNIT_ASSERT_EQUAL(!expected.empty(), set.match(word));
+    }
+}
+
+void GlobSetUnit::infix()
+{
+    const char  *patterns[] = {
+        "*ab*", "*a?b*", "*{ab,ca}c*", "a*b*", "*b", "*c*.*", "ab*", "*.c", "*bc*", "^*b*", "*"
+    };
+    std::vector<Glob>   globs;
+    GlobSet             set;
+    for (size_t i = 0; i < sizeof(patterns) / sizeof(patterns[0]); ++i)
+    {
+        CPPUNIT_ASSERT(set.add(patterns[i]));
+        globs.push_back(Glob(patterns[i]));
+    }
+    std::vector<size_t> which;
+    std::vector<size_t> expected;
+    srand(3);
+    for (int i = 0; i < 1000; ++i)
+    {
+        std::string word;
+        for (int n = rand() % 12; n > 0; --n)
+            word += "abc."[rand() % 4];
+        expected.clear();
+        for (size_t g = 0; g < globs.size(); ++g)
+        {
+            if (globs[g].match(word))
+                expected.push_back(g);
+        }
+        which.clear();
+        CPPUNIT_ASSERT_EQUAL(expected.size(), set.match(word, which));
+        CPPUNIT_ASSERT(expected == which);
+    }
+    // Each matches once however many times it is found
+    which.clear();
+    CPPUNIT_ASSERT_EQUAL(size_t(7), set.match("abcabcab", which));
+    const size_t    found[] = { 0, 2, 3, 4, 6, 8, 10 };
+    for (size_t i = 0; i < 7; ++i)
+        CPPUNIT_ASSERT_EQUAL(found[i], which[i]);
+}
+
+void GlobSetUnit::copy()
+{
+    GlobSet *set = new GlobSet();
+    set->add("*.o");        // 0
+    set->add("*.cpp");      // 1
+    set->add("m*");         // 2
+    set->add("^*.h");       // 3
+    CPPUNIT_ASSERT(set->match("m.cpp"));
+    GlobSet copy(*set);
+    GlobSet assigned;
+    assigned.add("*.x");
+    CPPUNIT_ASSERT(assigned.match("a.x"));
+    assigned = *set;
+    delete set;
+
+    std::vector<size_t> which;
+    CPPUNIT_ASSERT_EQUAL(size_t(3), copy.match("m.cpp", which));
+    CPPUNIT_ASSERT_EQUAL(size_t(1), which[0]);
+    CPPUNIT_ASSERT_EQUAL(size_t(2), which[1]);
+    CPPUNIT_ASSERT_EQUAL(size_t(3), which[2]);
+    which.clear();
+    CPPUNIT_ASSERT_EQUAL(size_t(2), assigned.match("a.o", which));
+    CPPUNIT_ASSERT_EQUAL(size_t(4), assigned.size());
+    CPPUNIT_ASSERT(!assigned.match("a.h"));
+
+    // Adding to a compiled copy still works
+    copy.add("*.x");
+    CPPUNIT_ASSERT(copy.match("a.x"));
+    CPPUNIT_ASSERT(copy.match("a.o"));
+}
+
+void GlobSetUnit::threads()
+{
+    GlobSet set;
+    set.add("*.o");
+    set.add("*_test_*");
+    set.add("mod[0-9].{c,h}");
+    set.add("^*.*");
+    set.compile();
+    const char  *words[] = { "a.o", "x_test_y", "mod3.h", "README", "mod3.o", "b.c" };
+    const size_t count[] = { 1, 2, 1, 1, 1, 0 };
+    std::atomic<int>            wrong(0);
+    std::vector<std::thread>    threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.push_back(std::thread([&]() {
+            std::vector<size_t> which;
+            for (int i = 0; i < 1000; ++i)
+            {
+                which.clear();
+                if (set.match(words[i % 6], which) != count[i % 6])
+                    ++wrong;
+            }
+        }));
+    }
+    for (size_t t = 0; t < threads.size(); ++t)
+        threads[t].join();
+    CPPUNIT_ASSERT_EQUAL(0, int(wrong));
+}
@@ -7,6 +7,8 @@
 #include <cppunit/TestCase.h>
 #include <cppunit/extensions/HelperMacros.h>
 
+#include <fnmatch.h>
+#include <stdlib.h>
 #include <sstream>
 #include <vector>
 #include <string>
@@ -21,11 +23,32 @@ class GlobUnit : public CppUnit::TestCase
     CPPUNIT_TEST_SUITE(GlobUnit);
 
     CPPUNIT_TEST(init);
+    CPPUNIT_TEST(wildcards);
+    CPPUNIT_TEST(brackets);
+    CPPUNIT_TEST(braces);
+    CPPUNIT_TEST(negate);
+    CPPUNIT_TEST(literals);
+    CPPUNIT_TEST(malformed);
+    CPPUNIT_TEST(fnmatch);
 
     CPPUNIT_TEST_SUITE_END();
 protected:
     /// Test constructor
     void init();
+    /// Test '*' and '?'
+    void wildcards();
+    /// Test [...]
+    void brackets();
+    /// Test {...}
+    void braces();
+    /// Test a leading '^'
+    void negate();
+    /// Test the regular characters a match must have
+    void literals();
+    /// Test patterns that don't compile
+    void malformed();
+    /// Compare with fnmatch(3) for random patterns and words
+    void fnmatch();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(GlobUnit);
@@ -36,4 +59,206 @@ void GlobUnit::init()
 
     CPPUNIT_ASSERT (!g.match ("b"));
     CPPUNIT_ASSERT (g.match ("a"));
+    CPPUNIT_ASSERT (!g.match ("aa"));
+    CPPUNIT_ASSERT (!g.match (""));
+    CPPUNIT_ASSERT (g.compile ());
+    CPPUNIT_ASSERT_EQUAL (std::string ("a"), g.pattern ());
+
+    Glob    copy (g);
+    CPPUNIT_ASSERT (copy.match (std::string ("a")));
+    copy = Glob ("b");
+    CPPUNIT_ASSERT (copy.match ("b"));
+    CPPUNIT_ASSERT (g.match ("a"));
+
+    Glob    empty ("");
+    CPPUNIT_ASSERT (empty.match (""));
+    CPPUNIT_ASSERT (!empty.match ("a"));
+}
+
+void GlobUnit::wildcards()
+{
+    Glob    star ("*.C");
+    CPPUNIT_ASSERT (star.match ("test.C"));
+    CPPUNIT_ASSERT (star.match (".C"));
+    CPPUNIT_ASSERT (star.match ("a.C.C"));
+    CPPUNIT_ASSERT (!star.match ("test.c"));
+    CPPUNIT_ASSERT (!star.match ("test.Cc"));
+
+    Glob    middle ("a*b*c");
+    CPPUNIT_ASSERT (middle.match ("abc"));
+    CPPUNIT_ASSERT (middle.match ("aXXbYYc"));
+    CPPUNIT_ASSERT (middle.match ("abcbc"));
+    CPPUNIT_ASSERT (!middle.match ("acb"));
+
+    Glob    any ("*");
+    CPPUNIT_ASSERT (any.match (""));
+    CPPUNIT_ASSERT (any.match ("anything at all"));
+
+    Glob    one ("test.?");
+    CPPUNIT_ASSERT (one.match ("test.c"));
+    CPPUNIT_ASSERT (one.match ("test.?"));
+    CPPUNIT_ASSERT (!one.match ("test."));
+    CPPUNIT_ASSERT (!one.match ("test.cc"));
+
+    Glob    escaped ("\\*\\?");
+    CPPUNIT_ASSERT (escaped.match ("*?"));
+    CPPUNIT_ASSERT (!escaped.match ("ab"));
+
+    // Every byte is a regular character, including '~' and high bytes
+    Glob    bytes ("~\xe9*");
+    CPPUNIT_ASSERT (bytes.match ("~\xe9t\xe9"));
+    CPPUNIT_ASSERT (!bytes.match ("~e"));
+    CPPUNIT_ASSERT (Glob ("a?c").match (std::string ("a\0c", 3)));
+}
+
+void GlobUnit::brackets()
+{
+    Glob    list ("*.[ch]");
+    CPPUNIT_ASSERT (list.match ("x.c"));
+    CPPUNIT_ASSERT (list.match ("x.h"));
+    CPPUNIT_ASSERT (!list.match ("x.o"));
+    CPPUNIT_ASSERT (!list.match ("x.ch"));
+
+    Glob    range ("*[0-9].cpp");
+    CPPUNIT_ASSERT (range.match ("test1.cpp"));
+    CPPUNIT_ASSERT (!range.match ("test.cpp"));
+
+    Glob    notRange ("*[^0-9].cpp");
+    CPPUNIT_ASSERT (notRange.match ("test.cpp"));
+    CPPUNIT_ASSERT (!notRange.match ("test1.cpp"));
+    CPPUNIT_ASSERT (Glob ("[!a]").match ("b"));
+    CPPUNIT_ASSERT (!Glob ("[!a]").match ("a"));
+
+    // ']' first and '-' at either end are part of the list
+    Glob    special ("[]a-]");
+    CPPUNIT_ASSERT (special.match ("]"));
+    CPPUNIT_ASSERT (special.match ("a"));
+    CPPUNIT_ASSERT (special.match ("-"));
+    CPPUNIT_ASSERT (!special.match ("b"));
+    CPPUNIT_ASSERT (Glob ("[-z]").match ("-"));
+
+    // An unclosed '[' is just a character
+    Glob    open ("a[b");
+    CPPUNIT_ASSERT (open.compile ());
+    CPPUNIT_ASSERT (open.match ("a[b"));
+    CPPUNIT_ASSERT (!open.match ("ab"));
+
+    // Backwards ranges match nothing
+    CPPUNIT_ASSERT (!Glob ("[z-a]").match ("m"));
+}
+
+void GlobUnit::braces()
+{
+    Glob    ext ("test.{c,cpp,h}");
+    CPPUNIT_ASSERT (ext.match ("test.c"));
+    CPPUNIT_ASSERT (ext.match ("test.cpp"));
+    CPPUNIT_ASSERT (ext.match ("test.h"));
+    CPPUNIT_ASSERT (!ext.match ("test.cp"));
+    CPPUNIT_ASSERT (!ext.match ("test."));
+
+    Glob    nested ("{a,b{1,2},*.[ch]}x");
+    CPPUNIT_ASSERT (nested.match ("ax"));
+    CPPUNIT_ASSERT (nested.match ("b1x"));
+    CPPUNIT_ASSERT (nested.match ("b2x"));
+    CPPUNIT_ASSERT (nested.match ("foo.hx"));
+    CPPUNIT_ASSERT (!nested.match ("bx"));
+    CPPUNIT_ASSERT (!nested.match ("b3x"));
+
+    Glob    emptyAlt ("a{,b}");
+    CPPUNIT_ASSERT (emptyAlt.match ("a"));
+    CPPUNIT_ASSERT (emptyAlt.match ("ab"));
+
+    // Outside braces ',' and '}' are regular; "{}" is too
+    CPPUNIT_ASSERT (Glob ("a,b}").match ("a,b}"));
+    CPPUNIT_ASSERT (Glob ("x{}").match ("x{}"));
+    CPPUNIT_ASSERT (Glob ("{\\,,\\}}").match (","));
+    CPPUNIT_ASSERT (Glob ("{\\,,\\}}").match ("}"));
+}
+
+void GlobUnit::negate()
+{
+    Glob    notObject ("^*.o");
+    CPPUNIT_ASSERT (notObject.match ("test.c"));
+    CPPUNIT_ASSERT (notObject.match (""));
+    CPPUNIT_ASSERT (!notObject.match ("test.o"));
+
+    Glob    notList ("^{a,b}*");
+    CPPUNIT_ASSERT (notList.match ("cat"));
+    CPPUNIT_ASSERT (!notList.match ("bat"));
+
+    // On its own or escaped it is a regular character
+    CPPUNIT_ASSERT (Glob ("^").match ("^"));
+    CPPUNIT_ASSERT (Glob ("\\^a").match ("^a"));
+    CPPUNIT_ASSERT (!Glob ("\\^a").match ("b"));
+}
+
+void GlobUnit::literals()
+{
+    Glob    middle ("*_backup_*");
+    CPPUNIT_ASSERT (middle.match ("_backup_"));
+    CPPUNIT_ASSERT (middle.match ("a_backup_b"));
+    CPPUNIT_ASSERT (!middle.match ("a_backup"));
+    CPPUNIT_ASSERT (!middle.match ("_backu_"));
+
+    Glob    all ("core.*_x_?_y*z");
+    CPPUNIT_ASSERT (all.match ("core.a_x_1_yz"));
+    CPPUNIT_ASSERT (all.match ("core._x__x_1_y_yz"));
+    CPPUNIT_ASSERT (!all.match ("core._x_1_y"));
+    CPPUNIT_ASSERT (!all.match ("core.z"));
+    CPPUNIT_ASSERT (!all.match ("core_x_1_yz"));
+
+    // The prefix and suffix can't share characters of the word
+    CPPUNIT_ASSERT (!Glob ("ab*ba").match ("aba"));
+    CPPUNIT_ASSERT (Glob ("ab*ba").match ("abba"));
+
+    // Only what is outside braces and brackets is literal
+    CPPUNIT_ASSERT (Glob ("x{a,b}y*").match ("xby"));
+    CPPUNIT_ASSERT (Glob ("{}[.]\\*a[b").match ("{}.*a[b"));
+    CPPUNIT_ASSERT (!Glob ("{}[.]\\*a[b").match ("{}.*ab"));
+
+    // A negated pattern matches words without the literal
+    Glob    notLog ("^*.log");
+    CPPUNIT_ASSERT (notLog.match ("a.lo"));
+    CPPUNIT_ASSERT (notLog.match (""));
+    CPPUNIT_ASSERT (!notLog.match ("a.log"));
+}
+
+void GlobUnit::malformed()
+{
+    Glob    open ("test.{c,h");
+    CPPUNIT_ASSERT (!open.compile ());
+    CPPUNIT_ASSERT (!open.match ("test.c"));
+    CPPUNIT_ASSERT (!open.match ("test.{c,h"));
+    CPPUNIT_ASSERT (!Glob ("{").compile ());
+}
+
+void GlobUnit::fnmatch()
+{
+    // Patterns and words built from a few characters so they match often
+    const char  patternChars[] = "ab.*?[]!-\\";
+    const char  wordChars[] = "ab.-]";
+    srand (1);
+    for (int i = 0; i < 5000; ++i)
+    {
+        std::string pattern;
+        for (int n = rand () % 7; n > 0; --n)
+            pattern += patternChars[rand () % (sizeof (patternChars) - 1)];
+        // fnmatch() treats a trailing '\\' differently
+        if (!pattern.empty () && pattern[pattern.size () - 1] == '\\')
+            continue;
+        Glob    g (pattern);
+        for (int j = 0; j < 20; ++j)
+        {
+            std::string word;
+            for (int n = rand () % 6; n > 0; --n)
+                word += wordChars[rand () % (sizeof (wordChars) - 1)];
+            bool    expected = ::fnmatch (pattern.c_str (), word.c_str (), 0) == 0;
+            if (expected != g.match (word))
+            {
+                std::ostringstream  msg;
+                msg << "pattern \"" << pattern << "\" word \"" << word << '"';
+                CPPUNIT_FAIL (msg.str ());
+            }
+        }
+    }
 }
@@ -0,0 +1,122 @@
+/**
+ * @file HashTableUnit.cpp
+ * @ingroup PathTest
+ */
+#include <path/HashTable.h>
+#include <path/PathSet.h>
+#include <path/Canonical.h>
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <set>
+#include <string>
+
+using namespace path;
+
+/**
+ * Implements unit tests for HashSet, HashMap, PathSet and PathMap
+ */
+class HashTableUnit : public CppUnit::TestCase
+{
+    CPPUNIT_TEST_SUITE(HashTableUnit);
+
+    CPPUNIT_TEST(init);
+    CPPUNIT_TEST(insertErase);
+    CPPUNIT_TEST(collisions);
+    CPPUNIT_TEST(pathSet);
+
+    CPPUNIT_TEST_SUITE_END();
+
+protected:
+    /// Test constructor
+    void init();
+    /// Compare against std::set while inserting and erasing
+    void insertErase();
+    /// Check erase works when everything has the same hash
+    void collisions();
+    /// Test PathSet and PathMap
+    void pathSet();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(HashTableUnit);
+
+/// Puts every int in the same bucket
+struct BadHash
+{
+    size_t operator()(int) const
+    {
+        return 42;
+    }
+};
+
+void HashTableUnit::init()
+{
+    HashSet<int>    set;
+    CPPUNIT_ASSERT(set.empty());
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), set.count(1));
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), set.erase(1));
+    CPPUNIT_ASSERT(set.find(1) == set.end());
+}
+
+void HashTableUnit::insertErase()
+{
+    HashSet<int>    set;
+    std::set<int>   expected;
+
+    for (int i = 0; i < 5000; ++i)
+    {
+        int     value = (i * 7919) % 1000;
+        if (i % 3 == 2)
+        {
+            CPPUNIT_ASSERT_EQUAL(expected.erase(value), set.erase(value));
+        }
+        else
+        {
+            bool added = expected.insert(value).second;
+            CPPUNIT_ASSERT_EQUAL(added, set.insert(value).second);
+        }
+    }
+    CPPUNIT_ASSERT_EQUAL(expected.size(), set.size());
+    for (int i = 0; i < 1000; ++i)
+        CPPUNIT_ASSERT_EQUAL(expected.count(i), set.count(i));
+    CPPUNIT_ASSERT(std::set<int>(set.begin(), set.end()) == expected);
+
+    set.clear();
+    CPPUNIT_ASSERT(set.empty());
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), set.count(*expected.begin()));
+}
+
+void HashTableUnit::collisions()
+{
+    HashMap<int, std::string, BadHash> map;
+
+    for (int i = 0; i < 50; ++i)
+        map[i] = std::to_string(i);
+    for (int i = 0; i < 50; i += 2)
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), map.erase(i));
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(25), map.size());
+    for (int i = 0; i < 50; ++i)
+    {
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(i % 2), map.count(i));
+        if (i % 2)
+            CPPUNIT_ASSERT_EQUAL(std::to_string(i), map.find(i)->second);
+    }
+}
+
+void HashTableUnit::pathSet()
+{
+    PathSet     set;
+    set.insert(Path(UnixPath("/a/b")));
+    CPPUNIT_ASSERT(!set.insert(Path(UnixPath("/a//b/"))).second);
+    CPPUNIT_ASSERT(set.insert(Path(UnixPath("/a/c"))).second);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), set.size());
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), set.count(Path("/a/b")));
+
+    PathMap<int> map;
+    map[Path(UnixPath("/a/b"))] = 1;
+    map[Path("/a/b").makeShared() / "c"] = 2;
+    CPPUNIT_ASSERT_EQUAL(1, map[Path(UnixPath("/a/b"))]);
+    CPPUNIT_ASSERT_EQUAL(2, map[Path(UnixPath("/a/b/c"))]);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), map.size());
+}
@@ -6,8 +6,14 @@
 #include <path/PathIter.h>
 #include <path/SysBase.h>
 #include <path/PathException.h>
+#include <path/PathBadException.h>
 #include <path/Canonical.h>
 
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <regex>
+
 #include <cppunit/TestCase.h>
 #include <cppunit/extensions/HelperMacros.h>
 
@@ -20,6 +26,15 @@ class NodeUnit: public CppUnit::TestCase
     CPPUNIT_TEST(init);
     CPPUNIT_TEST(iter);
     CPPUNIT_TEST(iter_file);
+    CPPUNIT_TEST(iter_relative);
+    CPPUNIT_TEST(iter_relative_error);
+    CPPUNIT_TEST(iter_depth_first);
+    CPPUNIT_TEST(iter_shared);
+    CPPUNIT_TEST(iter_orders);
+    CPPUNIT_TEST(iter_prune);
+    CPPUNIT_TEST(iter_listed);
+    CPPUNIT_TEST(iter_pattern);
+    CPPUNIT_TEST(glob);
     CPPUNIT_TEST(opers);
     CPPUNIT_TEST_SUITE_END();
 public:
@@ -32,6 +47,24 @@ protected:
     void iter();
     /// Make sure we handle regular files
     void iter_file();
+    /// Recursive iteration relative to open directories
+    void iter_relative();
+    /// Errors name the whole path when iterating relative to directories
+    void iter_relative_error();
+    /// Recursive iteration visits a directory's contents right after it
+    void iter_depth_first();
+    /// Copies share state until one moves
+    void iter_shared();
+    /// Depth first, breadth first and in order
+    void iter_orders();
+    /// prune(), setDirFilter() and setMaxDepth()
+    void iter_prune();
+    /// Entries know what readdir() found out
+    void iter_listed();
+    /// Only visit names matching a glob or regular expression
+    void iter_pattern();
+    /// Path::glob() with several components and "**"
+    void glob();
     /// Test PathIter operators
     void opers();
 
@@ -183,6 +216,373 @@ void NodeUnit::iter_file()
     System.remove(testfile.str());
 }
 
+void NodeUnit::iter_relative()
+{
+    buildFiles();
+    Path    deeper = m_base.add("subdir").add("deeper");
+    System.mkdir(deeper.path());
+    System.touch(deeper.add("x").path());
+    CPPUNIT_ASSERT_EQUAL(0, ::symlink("deeper", m_base.add("subdir").add("link").path().c_str()));
+    Node    node(m_base);
+
+    Strings byPath;
+    for (Node::iterator iter = node.begin().setRecursive(); iter != node.end(); ++iter)
+        byPath.push_back(iter->path());
+    Strings relative;
+    for (Node::iterator iter = node.begin().setRelative().setRecursive(); iter != node.end(); ++iter)
+        relative.push_back(iter->path());
+
+    // 5 entries, deeper, link, deeper/x and link/x
+    CPPUNIT_ASSERT_EQUAL(size_t(9), byPath.size());
+    CPPUNIT_ASSERT(byPath == relative);
+
+    System.remove(m_base.add("subdir").add("link").path());
+    System.remove(deeper.add("x").path());
+    System.rmdir(deeper.path());
+}
+
+void NodeUnit::iter_relative_error()
+{
+    buildFiles();
+    Path    link = m_base.add("subdir").add("dangling");
+    CPPUNIT_ASSERT_EQUAL(0, ::symlink("missing", link.path().c_str()));
+    Node    node(m_base);
+
+    std::string byPath;
+    try
+    {
+        for (Node::iterator iter = node.begin().setRecursive(); iter != node.end(); ++iter)
+            ;
+    }
+    catch (const PathBadException &e)
+    {
+        byPath = e.filename();
+    }
+    std::string relative;
+    try
+    {
+        for (Node::iterator iter = node.begin().setRelative().setRecursive(); iter != node.end(); ++iter)
+            ;
+    }
+    catch (const PathBadException &e)
+    {
+        relative = e.filename();
+    }
+    System.remove(link.path());
+    CPPUNIT_ASSERT_EQUAL(link.path(), byPath);
+    CPPUNIT_ASSERT_EQUAL(link.path(), relative);
+}
+
+void NodeUnit::iter_depth_first()
+{
+    buildFiles();
+    Path    abc = m_base.add("subdir").add("abc");
+    System.touch(abc.path());
+    System.touch(m_base.add("zzz").path());
+    Node    node(m_base);
+
+    Strings found;
+    for (Node::iterator iter = node.begin().setRecursive(); iter != node.end(); ++iter)
+        found.push_back(iter->basename());
+    const char *expected[] = { "1", "22", "333", "4444", "subdir", "abc", "zzz" };
+    CPPUNIT_ASSERT_EQUAL(size_t(7), found.size());
+    for (size_t i = 0; i < found.size(); ++i)
+        CPPUNIT_ASSERT_EQUAL(std::string(expected[i]), found[i]);
+
+    // A copy carries on from the same place on its own
+    Node::iterator  iter = node.begin().setRecursive();
+    while (iter->basename() != "subdir")
+        ++iter;
+    Node::iterator  copy = iter++;
+    CPPUNIT_ASSERT_EQUAL(std::string("subdir"), copy->basename());
+    CPPUNIT_ASSERT_EQUAL(std::string("abc"), iter->basename());
+    ++copy;
+    CPPUNIT_ASSERT(copy == iter);
+    ++iter;
+    CPPUNIT_ASSERT_EQUAL(std::string("zzz"), iter->basename());
+    ++iter;
+    CPPUNIT_ASSERT(iter == node.end());
+
+    System.remove(abc.path());
+    System.remove(m_base.add("zzz").path());
+}
+
+void NodeUnit::iter_shared()
+{
+    buildFiles();
+    Node    node(m_base);
+
+    Node::iterator  iter = node.begin();
+    Node::iterator  copy(iter);
+    CPPUNIT_ASSERT(copy == iter);
+    CPPUNIT_ASSERT(&*copy == &*iter);
+
+    // Moving one leaves the other where it was
+    std::string first = iter->basename();
+    ++copy;
+    CPPUNIT_ASSERT(copy != iter);
+    CPPUNIT_ASSERT_EQUAL(first, iter->basename());
+    ++iter;
+    CPPUNIT_ASSERT(copy == iter);
+    CPPUNIT_ASSERT(&*copy != &*iter);
+
+    // Copies made at the end can be given more to visit
+    Node::iterator  end = node.end();
+    Node::iterator  extra(end);
+    extra.addPath(m_base);
+    CPPUNIT_ASSERT(end == node.end());
+    CPPUNIT_ASSERT(extra != node.end());
+    CPPUNIT_ASSERT(*extra == m_base);
+}
+
+void NodeUnit::iter_orders()
+{
+    buildFiles();
+    Path    subdir = m_base.add("subdir");
+    Path    inner = subdir.add("inner");
+    System.mkdir(inner.path());
+    System.touch(inner.add("x").path());
+    System.touch(subdir.add("abc").path());
+    System.touch(m_base.add("zzz").path());
+    Node    node(m_base);
+
+    const char *depth[] = { "1", "22", "333", "4444", "subdir", "abc", "inner", "x", "zzz" };
+    const char *breadth[] = { "1", "22", "333", "4444", "subdir", "zzz", "abc", "inner", "x" };
+    Strings found;
+    for (Node::iterator iter = node.begin().setRecursive(PathIter::DEPTH_FIRST); iter != node.end(); ++iter)
+        found.push_back(iter->basename());
+    CPPUNIT_ASSERT_EQUAL(size_t(9), found.size());
+    for (size_t i = 0; i < found.size(); ++i)
+        CPPUNIT_ASSERT_EQUAL(std::string(depth[i]), found[i]);
+
+    found.clear();
+    for (Node::iterator iter = node.begin().setRecursive(PathIter::BREADTH_FIRST); iter != node.end(); ++iter)
+        found.push_back(iter->basename());
+    CPPUNIT_ASSERT_EQUAL(size_t(9), found.size());
+    for (size_t i = 0; i < found.size(); ++i)
+        CPPUNIT_ASSERT_EQUAL(std::string(breadth[i]), found[i]);
+
+    // Whatever order readdir() gives, a directory is followed by its contents
+    found.clear();
+    for (Node::iterator iter = node.begin().setRelative().setRecursive(PathIter::IN_ORDER); iter != node.end(); ++iter)
+        found.push_back(iter->basename());
+    CPPUNIT_ASSERT_EQUAL(size_t(9), found.size());
+    Strings::iterator   x = std::find(found.begin(), found.end(), "x");
+    CPPUNIT_ASSERT(x != found.begin() && x != found.end());
+    CPPUNIT_ASSERT_EQUAL(std::string("inner"), *(x - 1));
+    Strings expected(depth, depth + 9);
+    std::sort(expected.begin(), expected.end());
+    std::sort(found.begin(), found.end());
+    CPPUNIT_ASSERT(expected == found);
+
+    System.remove(inner.add("x").path());
+    System.rmdir(inner.path());
+    System.remove(subdir.add("abc").path());
+    System.remove(m_base.add("zzz").path());
+}
+
+void NodeUnit::iter_prune()
+{
+    buildFiles();
+    Path    subdir = m_base.add("subdir");
+    Path    inner = subdir.add("inner");
+    System.mkdir(inner.path());
+    System.touch(inner.add("x").path());
+    System.touch(subdir.add("abc").path());
+    Node    node(m_base);
+
+    // Pruned directories are visited but not what is in them
+    Strings found;
+    for (Node::iterator iter = node.begin().setRecursive(); iter != node.end(); ++iter)
+    {
+        found.push_back(iter->basename());
+        if (iter->basename() == "subdir")
+            iter.prune();
+    }
+    const char *pruned[] = { "1", "22", "333", "4444", "subdir" };
+    CPPUNIT_ASSERT(Strings(pruned, pruned + 5) == found);
+
+    found.clear();
+    Node::iterator  iter = node.begin().setRecursive().setDirFilter([](const Path &dir) {
+        return dir.basename() != "inner";
+    });
+    for (; iter != node.end(); ++iter)
+        found.push_back(iter->basename());
+    const char *filtered[] = { "1", "22", "333", "4444", "subdir", "abc", "inner" };
+    CPPUNIT_ASSERT(Strings(filtered, filtered + 7) == found);
+
+    found.clear();
+    for (iter = node.begin().setRecursive().setMaxDepth(1); iter != node.end(); ++iter)
+        found.push_back(iter->basename());
+    CPPUNIT_ASSERT(Strings(filtered, filtered + 7) == found);
+
+    found.clear();
+    for (iter = node.begin().setRecursive(PathIter::BREADTH_FIRST).setMaxDepth(0); iter != node.end(); ++iter)
+        found.push_back(iter->basename());
+    CPPUNIT_ASSERT(Strings(pruned, pruned + 5) == found);
+
+    System.remove(inner.add("x").path());
+    System.rmdir(inner.path());
+    System.remove(subdir.add("abc").path());
+}
+
+void NodeUnit::iter_listed()
+{
+    buildFiles();
+    Node    node(m_base);
+    size_t  dirs = 0;
+    for (Node::iterator iter = node.begin(); iter != node.end(); ++iter)
+    {
+        const NodeInfo  &listed = iter->info(NodeInfo::TYPE);
+        CPPUNIT_ASSERT(listed.has(NodeInfo::TYPE));
+        CPPUNIT_ASSERT_EQUAL(iter->basename() == "subdir", iter->isDir());
+        if (iter->isDir())
+            ++dirs;
+        // Only stat() if readdir() didn't give the type
+        if (!listed.has(NodeInfo::SIZE) && !iter->isDir())
+        {
+            struct stat st;
+            CPPUNIT_ASSERT_EQUAL(0, ::stat(iter->path().c_str(), &st));
+            CPPUNIT_ASSERT_EQUAL(uint64_t(st.st_ino), iter->info(NodeInfo::INODE).inode());
+        }
+        // Anything else calls stat() for just that and keeps it
+        const NodeInfo  &sized = iter->info(NodeInfo::SIZE);
+        CPPUNIT_ASSERT(sized.has(NodeInfo::SIZE));
+        CPPUNIT_ASSERT_EQUAL(&sized, &iter->info(NodeInfo::SIZE));
+        CPPUNIT_ASSERT_EQUAL(&listed, &iter->info(NodeInfo::TYPE));
+        CPPUNIT_ASSERT(iter->info().has(NodeInfo::SIZE | NodeInfo::MODE | NodeInfo::MTIME));
+        CPPUNIT_ASSERT_EQUAL(&iter->info(), &iter->info(NodeInfo::UID));
+    }
+    CPPUNIT_ASSERT_EQUAL(size_t(1), dirs);
+}
+
+void NodeUnit::iter_pattern()
+{
+    buildFiles();
+    Path    subdir = m_base.add("subdir");
+    System.touch(subdir.add("a1").path());
+    System.touch(subdir.add("b22").path());
+
+    auto    found = [](PathIter iter) {
+        std::string names;
+        for (; iter != PathIter(); ++iter)
+            names += (names.empty() ? "" : " ") + iter->str();
+        return names;
+    };
+    CPPUNIT_ASSERT_EQUAL(std::string("temp/22 temp/333 temp/4444"),
+                         found(PathIter(m_base, "[0-9][0-9]*", false)));
+    CPPUNIT_ASSERT_EQUAL(std::string("temp/333 temp/4444"),
+                         found(PathIter(m_base, "^[0-9]{3}", true)));
+    CPPUNIT_ASSERT_EQUAL(std::string(""), found(PathIter(m_base, "nothing", false)));
+    // A regular expression is found anywhere in the name
+    CPPUNIT_ASSERT_EQUAL(std::string("temp/22 temp/subdir"),
+                         found(PathIter(m_base, "2$|b", true)));
+    bool    caught = false;
+    try
+    {
+        PathIter(m_base, "[0-9", true);
+    }
+    catch (std::regex_error &)
+    {
+        caught = true;
+    }
+    CPPUNIT_ASSERT(caught);
+
+    // Directories that don't match are still read
+    CPPUNIT_ASSERT_EQUAL(std::string("temp/22 temp/subdir/b22"),
+                         found(PathIter(m_base, "*22", false).setRecursive()));
+    CPPUNIT_ASSERT_EQUAL(std::string("temp/22 temp/subdir/b22"),
+                         found(PathIter(m_base, "*22", false).setRecursive(PathIter::BREADTH_FIRST)));
+    CPPUNIT_ASSERT_EQUAL(std::string("temp/subdir/a1"),
+                         found(PathIter(m_base, "a*", false).setRecursive()));
+    CPPUNIT_ASSERT_EQUAL(std::string(""),
+                         found(PathIter(m_base, "a*", false).setRecursive().setMaxDepth(0)));
+    CPPUNIT_ASSERT_EQUAL(std::string("temp/22"),
+                         found(PathIter(m_base, "*22", false).setRecursive().setDirFilter(
+                                   [](const Path &) { return false; })));
+    PathIter    extra(m_base, "*22", false);
+    extra.addPath(subdir.add("b22"));
+    extra.addPath(subdir.add("a1"));
+    CPPUNIT_ASSERT_EQUAL(std::string("temp/22 temp/subdir/b22"), found(extra));
+
+    // Copies keep the pattern
+    PathIter    iter(m_base, "[0-9]*", false);
+    PathIter    copy(iter);
+    ++iter;
+    CPPUNIT_ASSERT_EQUAL(std::string("temp/1"), copy->str());
+    CPPUNIT_ASSERT_EQUAL(std::string("temp/22"), iter->str());
+    ++copy;
+    CPPUNIT_ASSERT(copy == iter);
+    CPPUNIT_ASSERT(iter.match(Path("x/55")));
+    CPPUNIT_ASSERT(!iter.match(Path("55/x")));
+    CPPUNIT_ASSERT(PathIter(m_base).match(Path("x")));
+    System.remove(subdir.add("a1").path());
+    System.remove(subdir.add("b22").path());
+}
+
+void NodeUnit::glob()
+{
+    buildFiles();
+    Path    subdir = m_base.add("subdir");
+    Path    inner = subdir.add("inner");
+    Path    dot = m_base.add(".dot");
+    System.mkdir(inner.path());
+    System.mkdir(dot.path());
+    System.touch(subdir.add("a.gz").path());
+    System.touch(subdir.add("b.txt").path());
+    System.touch(subdir.add(".hidden.gz").path());
+    System.touch(inner.add("c.gz").path());
+    System.touch(dot.add("d.gz").path());
+    Node    node(m_base);
+
+    auto    glob = [&](const std::string &pattern) {
+        std::string found;
+        for (Node::iterator iter = node.glob(pattern); iter != node.end(); ++iter)
+            found += (found.empty() ? "" : " ") + iter->str();
+        return found;
+    };
+    CPPUNIT_ASSERT_EQUAL(std::string("temp/1 temp/22 temp/333 temp/4444 temp/subdir"), glob("*"));
+    CPPUNIT_ASSERT_EQUAL(std::string("temp/22"), glob("[0-9][0-9]"));
+    CPPUNIT_ASSERT_EQUAL(std::string("temp/subdir/a.gz"), glob("subdir/*.gz"));
+    CPPUNIT_ASSERT_EQUAL(std::string("temp/subdir/.hidden.gz"), glob("subdir/.*.gz"));
+    CPPUNIT_ASSERT_EQUAL(std::string("temp/subdir/a.gz"), glob("*/*.gz"));
+    CPPUNIT_ASSERT_EQUAL(std::string("temp/subdir/inner/c.gz"), glob("s*//inner/c.gz"));
+    CPPUNIT_ASSERT_EQUAL(std::string("temp/subdir/inner/c.gz"), glob("subdir/inner/c.gz"));
+    CPPUNIT_ASSERT_EQUAL(std::string(""), glob("subdir/missing"));
+    CPPUNIT_ASSERT_EQUAL(std::string(""), glob("missing/*.gz"));
+    CPPUNIT_ASSERT_EQUAL(std::string(""), glob("1/*"));
+    CPPUNIT_ASSERT_EQUAL(std::string(""), glob(""));
+
+    // "**" is any number of directories but not hidden ones
+    CPPUNIT_ASSERT_EQUAL(std::string("temp/subdir/a.gz temp/subdir/inner/c.gz"), glob("**/*.gz"));
+    CPPUNIT_ASSERT_EQUAL(std::string("temp/subdir/inner"), glob("**/inner"));
+    CPPUNIT_ASSERT_EQUAL(std::string("temp/subdir/inner/c.gz"), glob("subdir/**/**/c.gz"));
+    CPPUNIT_ASSERT_EQUAL(std::string("temp/subdir/a.gz temp/subdir/b.txt temp/subdir/inner temp/subdir/inner/c.gz"),
+                         glob("subdir/**"));
+
+    // Entries know their type without stat()
+    Node::iterator  iter = node.glob("sub*");
+    CPPUNIT_ASSERT(iter != node.end());
+    CPPUNIT_ASSERT(iter->isDir());
+    CPPUNIT_ASSERT(!iter->info(NodeInfo::TYPE).has(NodeInfo::SIZE));
+
+    // An absolute pattern doesn't depend on the Path
+    std::string abs = (Path::getcwd() / inner).str();
+    Path    root(Canonical("unused"));
+    Node::iterator  absolute = root.glob(abs + "/*.gz");
+    CPPUNIT_ASSERT(absolute != root.end());
+    CPPUNIT_ASSERT_EQUAL(abs + "/c.gz", absolute->str());
+    CPPUNIT_ASSERT(++absolute == root.end());
+
+    System.remove(inner.add("c.gz").path());
+    System.remove(dot.add("d.gz").path());
+    System.remove(subdir.add("a.gz").path());
+    System.remove(subdir.add("b.txt").path());
+    System.remove(subdir.add(".hidden.gz").path());
+    System.rmdir(inner.path());
+    System.rmdir(dot.path());
+}
+
 void NodeUnit::opers()
 {
     buildFiles();
@@ -0,0 +1,185 @@
+/**
+ * @file ParallelWalkerUnit.cpp
+ * @ingroup PathTest
+ */
+#include <path/ParallelWalker.h>
+#include <path/WalkQueue.h>
+#include <path/PathIter.h>
+#include <path/SysBase.h>
+
+#include <algorithm>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+using namespace path;
+
+/**
+ * Implements unit tests for ParallelWalker and WalkQueue classes
+ */
+class ParallelWalkerUnit : public CppUnit::TestCase
+{
+    CPPUNIT_TEST_SUITE(ParallelWalkerUnit);
+
+    CPPUNIT_TEST(queue);
+    CPPUNIT_TEST(walk);
+    CPPUNIT_TEST(walkQueue);
+    CPPUNIT_TEST(exception);
+
+    CPPUNIT_TEST_SUITE_END();
+public:
+    virtual void setUp();
+    virtual void tearDown();
+protected:
+    /// Test WalkQueue between threads
+    void queue();
+    /// Test walk() finds the same as a recursive PathIter
+    void walk();
+    /// Test start() with a WalkQueue
+    void walkQueue();
+    /// Test exceptions from the callback reach wait()
+    void exception();
+
+    /// Everything below m_base found by a recursive PathIter
+    Strings expected();
+
+    Path    m_base;     ///< Top of the temporary tree
+    Strings m_dirs;     ///< Directories created in order
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ParallelWalkerUnit);
+
+void ParallelWalkerUnit::setUp()
+{
+    m_base = Path("walktemp");
+    m_dirs.clear();
+    m_dirs.push_back(m_base.path());
+    for (int i = 0; i < 4; ++i)
+    {
+        Path    a = m_base.add("d" + std::to_string(i));
+        m_dirs.push_back(a.path());
+        for (int j = 0; j < 3; ++j)
+            m_dirs.push_back(a.add("e" + std::to_string(j)).path());
+    }
+    for (Strings::const_iterator iter = m_dirs.begin(); iter != m_dirs.end(); ++iter)
+    {
+        System.mkdir(*iter);
+        System.touch(*iter + "/f1");
+        System.touch(*iter + "/f2");
+    }
+}
+
+void ParallelWalkerUnit::tearDown()
+{
+    for (Strings::reverse_iterator iter = m_dirs.rbegin(); iter != m_dirs.rend(); ++iter)
+    {
+        System.remove(*iter + "/f1");
+        System.remove(*iter + "/f2");
+        System.rmdir(*iter);
+    }
+}
+
+Strings ParallelWalkerUnit::expected()
+{
+    Strings     result;
+    for (PathIter iter = PathIter(m_base).setRecursive(); iter != PathIter(); ++iter)
+        result.push_back(iter->path());
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+void ParallelWalkerUnit::queue()
+{
+    WalkQueue   q(2);
+    CPPUNIT_ASSERT_EQUAL(size_t(2), q.capacity());
+
+    std::thread producer([&q]() {
+        for (int i = 0; i < 100; ++i)
+            q.push(Path("p" + std::to_string(i)), NodeInfo::FILE);
+        q.close();
+    });
+    Path            p;
+    NodeInfo::Type  type = NodeInfo::UNKNOWN;
+    int             count = 0;
+    while (q.pop(p, &type))
+    {
+        CPPUNIT_ASSERT_EQUAL("p" + std::to_string(count), p.path());
+        CPPUNIT_ASSERT_EQUAL(NodeInfo::FILE, type);
+        ++count;
+    }
+    producer.join();
+    CPPUNIT_ASSERT_EQUAL(100, count);
+    CPPUNIT_ASSERT(q.closed());
+    CPPUNIT_ASSERT(!q.push(p));
+}
+
+void ParallelWalkerUnit::walk()
+{
+    Strings     found;
+    std::mutex  mutex;
+    size_t      dirs = 0;
+
+    ParallelWalker  walker(4);
+    CPPUNIT_ASSERT_EQUAL(4u, walker.threads());
+    walker.walk(m_base, [&](const Path &p, NodeInfo::Type type) {
+        std::lock_guard<std::mutex> lock(mutex);
+        found.push_back(p.path());
+        if (type == NodeInfo::DIRECTORY)
+            ++dirs;
+    });
+    std::sort(found.begin(), found.end());
+    CPPUNIT_ASSERT_EQUAL(size_t(m_dirs.size() * 3 - 1), found.size());
+    CPPUNIT_ASSERT_EQUAL(m_dirs.size() - 1, dirs);
+    CPPUNIT_ASSERT(expected() == found);
+
+    // Can be used again
+    found.clear();
+    walker.walk(m_base.add("d1"), [&](const Path &p, NodeInfo::Type) {
+        std::lock_guard<std::mutex> lock(mutex);
+        found.push_back(p.path());
+    });
+    CPPUNIT_ASSERT_EQUAL(size_t(3 * 3 + 2), found.size());
+}
+
+void ParallelWalkerUnit::walkQueue()
+{
+    ParallelWalker  walker(3);
+    WalkQueue       q(4);
+    Strings         found;
+    Path            p;
+
+    walker.start(m_base, q);
+    while (q.pop(p))
+        found.push_back(p.path());
+    walker.wait();
+    std::sort(found.begin(), found.end());
+    CPPUNIT_ASSERT(expected() == found);
+
+    // Closing the queue stops the walk
+    WalkQueue       q2(1);
+    walker.start(m_base, q2);
+    CPPUNIT_ASSERT(q2.pop(p));
+    q2.close();
+    walker.wait();
+}
+
+void ParallelWalkerUnit::exception()
+{
+    ParallelWalker  walker(2);
+    bool            caught = false;
+    try
+    {
+        walker.walk(m_base, [](const Path &, NodeInfo::Type) {
+            throw std::runtime_error("stop");
+        });
+    }
+    catch (std::runtime_error &)
+    {
+        caught = true;
+    }
+    CPPUNIT_ASSERT(caught);
+}
@@ -0,0 +1,84 @@
+/**
+ * @file PathTableUnit.cpp
+ * @ingroup PathTest
+ */
+#include <path/PathTable.h>
+#include <path/Canonical.h>
+#include <path/RulesWin32.h>
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+using namespace path;
+
+/**
+ * Implements unit tests for PathTable class
+ *
+ */
+class PathTableUnit : public CppUnit::TestCase
+{
+    CPPUNIT_TEST_SUITE(PathTableUnit);
+
+    CPPUNIT_TEST(init);
+    CPPUNIT_TEST(intern);
+    CPPUNIT_TEST(lifetime);
+
+    CPPUNIT_TEST_SUITE_END();
+
+protected:
+    /// Test constructor
+    void init();
+    /// Test intern() and id()
+    void intern();
+    /// Test interned paths outlive the table
+    void lifetime();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(PathTableUnit);
+
+void PathTableUnit::init()
+{
+    PathTable   table;
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), table.size());
+}
+
+void PathTableUnit::intern()
+{
+    PathTable   table;
+    Path    p1 = table.intern(Path(UnixPath("/a/b")));
+    Path    p2 = table.intern(Path(UnixPath("/a//b/")));
+    Path    p3 = table.intern(Path(UnixPath("/a/c")));
+
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), table.size());
+    CPPUNIT_ASSERT(table.contains(p1));
+    CPPUNIT_ASSERT(!table.contains(Path(UnixPath("/a/b"))));
+    CPPUNIT_ASSERT(p1.sameTable(p3));
+    CPPUNIT_ASSERT_EQUAL(p1, p2);
+    CPPUNIT_ASSERT(p1 != p3);
+    CPPUNIT_ASSERT_EQUAL(table.id(p1), table.id(p2));
+    CPPUNIT_ASSERT(table.id(p1) != table.id(p3));
+    CPPUNIT_ASSERT_EQUAL(p3, table[table.id(p3)]);
+
+    // Interned and non-interned still compare by value
+    CPPUNIT_ASSERT_EQUAL(Path(UnixPath("/a/b")), p1);
+    CPPUNIT_ASSERT(Path(UnixPath("/a/c")) != p1);
+
+    // Different rules are different paths
+    Path    p4 = table.intern(Path(UnixPath("/a/b"), &RulesWin32::rules));
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), table.size());
+    CPPUNIT_ASSERT(p4 != p1);
+}
+
+void PathTableUnit::lifetime()
+{
+    Path    p1;
+    Path    p2;
+    {
+        PathTable   table;
+        p1 = table.intern(Path(UnixPath("/a/b")));
+        p2 = table.intern(Path(UnixPath("/a/c")));
+    }
+    CPPUNIT_ASSERT(!p1.sameTable(p2));
+    CPPUNIT_ASSERT(p1 != p2);
+    CPPUNIT_ASSERT_EQUAL(Path(UnixPath("/a/b")), p1);
+}
@@ -8,6 +8,11 @@
 #include <path/Canonical.h>
 #include <path/PathException.h>
 
+#include <map>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
 #include <cppunit/TestCase.h>
 #include <cppunit/extensions/HelperMacros.h>
 
@@ -46,6 +51,12 @@ class PathUnit : public CppUnit::TestCase
     CPPUNIT_TEST(testmk);
     CPPUNIT_TEST_EXCEPTION(testInfo, path::PathException);
     CPPUNIT_TEST(testStrings2Paths);
+    CPPUNIT_TEST(testShared);
+    CPPUNIT_TEST(testThreads);
+    CPPUNIT_TEST(testMove);
+    CPPUNIT_TEST(testLazy);
+    CPPUNIT_TEST(testHash);
+    CPPUNIT_TEST(testStringView);
 
     CPPUNIT_TEST_SUITE_END();
 
@@ -80,6 +91,18 @@ protected:
     void testInfo();
     /// Check that Path::strings2Paths works
     void testStrings2Paths();
+    /// Check that Path::makeShared() children behave like regular paths
+    void testShared();
+    /// Check copies of a Path can be used from several threads
+    void testThreads();
+    /// Check move constructor, assignment and add()
+    void testMove();
+    /// Check Paths made from strings are only parsed when needed
+    void testLazy();
+    /// Check hash() and operator<()
+    void testHash();
+    /// Check the std::string_view overloads
+    void testStringView();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(PathUnit);
@@ -347,3 +370,178 @@ void PathUnit::testStrings2Paths()
     paths = path::strings2Paths(src);
     CPPUNIT_ASSERT_EQUAL(src.size(), paths.size());
 }
+
+void PathUnit::testShared()
+{
+    Path    root = Path(UnixPath("/a/b")).makeShared();
+    CPPUNIT_ASSERT(root.shared());
+    CPPUNIT_ASSERT(!Path(UnixPath("/a/b")).shared());
+    CPPUNIT_ASSERT_EQUAL(Path(UnixPath("/a/b")), root);
+
+    Path    p1 = root / "c" / "d";
+    CPPUNIT_ASSERT(p1.shared());
+    CPPUNIT_ASSERT_EQUAL(Path(UnixPath("/a/b/c/d")), p1);
+    CPPUNIT_ASSERT_EQUAL(std::string("/a/b/c/d"), p1.str());
+    CPPUNIT_ASSERT_EQUAL(std::string("d"), p1.basename());
+    CPPUNIT_ASSERT_EQUAL(Path(UnixPath("/a/b/c")), p1.dirname());
+    CPPUNIT_ASSERT_EQUAL(root, p1.dirname().dirname());
+    CPPUNIT_ASSERT_EQUAL(Path(UnixPath("/a")), root.dirname());
+    CPPUNIT_ASSERT(p1.abs());
+
+    CPPUNIT_ASSERT_EQUAL(Path(UnixPath("/a/b/c/d.txt")), p1 + ".txt");
+    CPPUNIT_ASSERT_EQUAL(std::string(".txt"), (p1 + ".txt").extension());
+    CPPUNIT_ASSERT_EQUAL(Path(UnixPath("/a/b/x/y")), root.add(Path(UnixPath("x/y"))));
+
+    Strings names;
+    names.push_back("e");
+    names.push_back("f");
+    CPPUNIT_ASSERT_EQUAL(Path(UnixPath("/a/b/c/d/e/f")), p1.add(names));
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(4), p1.split().size());
+}
+
+void PathUnit::testThreads()
+{
+    Path    root = Path(UnixPath("/a/b")).makeShared();
+    Path    child = root / "c";
+    std::vector<std::thread>    workers;
+
+    for (int i = 0; i < 4; ++i)
+    {
+        workers.push_back(std::thread([child]() {
+            for (int j = 0; j < 1000; ++j)
+            {
+                Path copy(child);
+                CPPUNIT_ASSERT_EQUAL(std::string("/a/b/c"), copy.str());
+                CPPUNIT_ASSERT_EQUAL(std::string("/a/b/c"), copy.path());
+            }
+        }));
+    }
+    for (size_t i = 0; i < workers.size(); ++i)
+        workers[i].join();
+}
+
+void PathUnit::testMove()
+{
+    Path    p1(UnixPath("/a/b"));
+    Path    p2(std::move(p1));
+
+    CPPUNIT_ASSERT_EQUAL(Path(UnixPath("/a/b")), p2);
+    // Moved from is an empty path
+    CPPUNIT_ASSERT_EQUAL(Path(), p1);
+    CPPUNIT_ASSERT_EQUAL(std::string(""), p1.str());
+    CPPUNIT_ASSERT_EQUAL(std::string(""), p1.path());
+    CPPUNIT_ASSERT_EQUAL(size_t(0), p1.canon().size());
+    CPPUNIT_ASSERT_EQUAL(Path().hash(), p1.hash());
+    bool    caught = false;
+    try
+    {
+        p1.info(NodeInfo::TYPE);
+    }
+    catch (PathException &)
+    {
+        caught = true;
+    }
+    CPPUNIT_ASSERT(caught);
+    // Nothing is left behind for other empty Paths to share
+    RulesBase  *old = Path::setDefaultRulesBase(&RulesUnix::rules);
+    CPPUNIT_ASSERT_EQUAL(std::string(""), Path().str());
+    CPPUNIT_ASSERT(!Path().canon().abs());
+    Path::setDefaultRulesBase(old);
+
+    p1 = std::move(p2);
+    CPPUNIT_ASSERT_EQUAL(Path(UnixPath("/a/b")), p1);
+    CPPUNIT_ASSERT_EQUAL(Path(), p2);
+
+    std::string name("a_long_directory_name_to_move");
+    p2 = p1.add(std::move(name));
+    CPPUNIT_ASSERT_EQUAL(Path(UnixPath("/a/b/a_long_directory_name_to_move")), p2);
+    p2 = p1 / std::string("c");
+    CPPUNIT_ASSERT_EQUAL(Path(UnixPath("/a/b/c")), p2);
+
+    Canonical   c(UnixPath("/x/y"));
+    Path    p3(std::move(c), &RulesUnix::rules);
+    CPPUNIT_ASSERT_EQUAL(std::string("/x/y"), p3.str());
+}
+
+void PathUnit::testLazy()
+{
+    Path    p1("/a//b/c");
+
+    // str() and path() are the string exactly as given
+    CPPUNIT_ASSERT_EQUAL(std::string("/a//b/c"), p1.str());
+    CPPUNIT_ASSERT_EQUAL(&p1.str(), &p1.path());
+
+    // Anything looking at the components parses it
+    CPPUNIT_ASSERT_EQUAL(std::string("c"), p1.basename());
+    CPPUNIT_ASSERT_EQUAL(Path(UnixPath("/a/b")), p1.dirname());
+    CPPUNIT_ASSERT_EQUAL(Path(UnixPath("/a/b/c")), p1);
+    CPPUNIT_ASSERT(p1.abs());
+    CPPUNIT_ASSERT_EQUAL(std::string("/a//b/c"), p1.str());
+
+    // Variables are still expanded by path()
+    StringMap   vars;
+    vars["HOME"] = "/home/user";
+    Path    p2(std::string("~/x"));
+    CPPUNIT_ASSERT_EQUAL(std::string("~/x"), p2.str());
+    CPPUNIT_ASSERT(p2.path() != p2.str());
+    CPPUNIT_ASSERT_EQUAL(std::string("user"), p2.expand(vars).dirname().basename());
+
+    // A shared root is parsed when one of its children needs it
+    Path    root = Path("/x//y").makeShared();
+    Path    child = root / "z" / "w";
+    CPPUNIT_ASSERT_EQUAL(std::string("/x//y"), root.str());
+    CPPUNIT_ASSERT_EQUAL(std::string("/x/y/z/w"), child.str());
+    CPPUNIT_ASSERT_EQUAL(Path(UnixPath("/x/y/z")), child.dirname());
+    CPPUNIT_ASSERT_EQUAL(root, child.dirname().dirname());
+    CPPUNIT_ASSERT(child.abs());
+}
+
+void PathUnit::testHash()
+{
+    Path    p1(UnixPath("/a/b"));
+    Path    p2("/a//b/");
+    Path    p3 = Path(UnixPath("/a")).makeShared() / "b";
+    Path    p4(UnixPath("/a/c"));
+
+    CPPUNIT_ASSERT_EQUAL(p1.hash(), p2.hash());
+    CPPUNIT_ASSERT_EQUAL(p1.hash(), p3.hash());
+    CPPUNIT_ASSERT(p1.hash() != p4.hash());
+    CPPUNIT_ASSERT_EQUAL(p1.hash(), std::hash<Path>()(Path(p1)));
+    CPPUNIT_ASSERT(Path().hash() != 0);
+
+    CPPUNIT_ASSERT(!(p1 < p2) && !(p2 < p1));
+    CPPUNIT_ASSERT(!(p1 < p3) && !(p3 < p1));
+    CPPUNIT_ASSERT((p1 < p4) != (p4 < p1));
+
+    std::unordered_set<Path>    set;
+    set.insert(p1);
+    set.insert(p2);
+    set.insert(p4);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), set.size());
+    std::map<Path, int>         map;
+    map[p1] = 1;
+    map[p3] = 3;
+    map[p4] = 4;
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), map.size());
+    CPPUNIT_ASSERT_EQUAL(3, map[p2]);
+}
+
+void PathUnit::testStringView()
+{
+    std::string         str("/a/b/c/d");
+    std::string_view    view(str);
+
+    Path    p1(view.substr(0, 4));
+    CPPUNIT_ASSERT_EQUAL(std::string("/a/b"), p1.str());
+    CPPUNIT_ASSERT_EQUAL(Path(UnixPath("/a/b")), p1);
+    CPPUNIT_ASSERT_EQUAL(Path(UnixPath("/a/b/c")), p1 / view.substr(5, 1));
+    CPPUNIT_ASSERT_EQUAL(Path(UnixPath("/a/b/c")), p1.add(view.substr(5, 1)));
+    CPPUNIT_ASSERT_EQUAL(Path(UnixPath("/a/bc")), p1 + view.substr(5, 1));
+
+    Path    shared = p1.makeShared();
+    CPPUNIT_ASSERT_EQUAL(Path(UnixPath("/a/b/d")), shared / view.substr(7));
+    CPPUNIT_ASSERT_EQUAL(Path(UnixPath("/a/b/d.h")), (shared / view.substr(7)) + std::string_view(".h"));
+
+    CPPUNIT_ASSERT_EQUAL(UnixPath("/a/b/c/d"), RulesUnix::rules.canonical(view));
+    CPPUNIT_ASSERT_EQUAL(UnixPath("/a/b"), RulesUnix::rules.canonical(view.substr(0, 5)));
+}
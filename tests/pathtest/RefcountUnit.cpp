@@ -4,6 +4,10 @@
  */
 #include <path/Refcount.h>
 
+#include <thread>
+#include <utility>
+#include <vector>
+
 #include <cppunit/TestCase.h>
 #include <cppunit/extensions/HelperMacros.h>
 
@@ -15,6 +19,9 @@ class RefcountUnit: public CppUnit::TestCase
     
 	CPPUNIT_TEST(init);
     CPPUNIT_TEST(deref);
+    CPPUNIT_TEST(move);
+    CPPUNIT_TEST(intrusive);
+    CPPUNIT_TEST(threads);
     
 	CPPUNIT_TEST_SUITE_END();
 
@@ -37,11 +44,24 @@ class RefcountUnit: public CppUnit::TestCase
     };
     /// Make declaring Refcount pointer for testing easier
     typedef Refcount<TestCount> TPtr;
+
+    /// Keeps the count in the object
+    class TestIntrusive : public RefcountBase, public TestCount
+    {
+    };
+    /// Refcount pointer using an intrusive count
+    typedef Refcount<TestIntrusive> IPtr;
 protected:
 	/// Test basic initialization
 	void init();
     /// Test dereferencing operations
     void deref();
+    /// Test move constructor and assignment
+    void move();
+    /// Test RefcountBase
+    void intrusive();
+    /// Test copying from multiple threads
+    void threads();
 };
 
 int RefcountUnit::TestCount::s_count;
@@ -75,3 +95,59 @@ void RefcountUnit::deref()
     CPPUNIT_ASSERT_EQUAL(1, ref->count());
     CPPUNIT_ASSERT_EQUAL(1, d.count());
 }
+
+void RefcountUnit::move()
+{
+    TPtr    ref(new TestCount);
+    TPtr    ref2(std::move(ref));
+
+    CPPUNIT_ASSERT(ref.get() == 0);
+    CPPUNIT_ASSERT_EQUAL(0, ref.count());
+    CPPUNIT_ASSERT_EQUAL(1, ref2.count());
+
+    TPtr    ref3;
+    ref3 = std::move(ref2);
+    CPPUNIT_ASSERT_EQUAL(1, ref3.count());
+    CPPUNIT_ASSERT_EQUAL(1, TestCount::s_count);
+
+    ref3 = ref3;
+    CPPUNIT_ASSERT_EQUAL(1, ref3.count());
+    ref3 = TPtr();
+    CPPUNIT_ASSERT_EQUAL(0, TestCount::s_count);
+}
+
+void RefcountUnit::intrusive()
+{
+    TestIntrusive  *raw = new TestIntrusive;
+    {
+        IPtr    ref(raw);
+        CPPUNIT_ASSERT_EQUAL(1, ref.count());
+        // Safe to create a second Refcount from the same pointer
+        IPtr    ref2(raw);
+        CPPUNIT_ASSERT_EQUAL(2, ref.count());
+        IPtr    ref3(ref2);
+        CPPUNIT_ASSERT_EQUAL(3, ref.count());
+    }
+    CPPUNIT_ASSERT_EQUAL(0, TestCount::s_count);
+}
+
+void RefcountUnit::threads()
+{
+    IPtr    ref(new TestIntrusive);
+    std::vector<std::thread>    workers;
+
+    for (int i = 0; i < 4; ++i)
+    {
+        workers.push_back(std::thread([ref]() {
+            for (int j = 0; j < 10000; ++j)
+            {
+                IPtr copy(ref);
+                IPtr moved(std::move(copy));
+            }
+        }));
+    }
+    for (size_t i = 0; i < workers.size(); ++i)
+        workers[i].join();
+    CPPUNIT_ASSERT_EQUAL(1, ref.count());
+    CPPUNIT_ASSERT_EQUAL(1, TestCount::s_count);
+}
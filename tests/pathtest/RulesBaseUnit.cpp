@@ -97,3 +97,30 @@ void RulesBaseUnit::convert()
 	CPPUNIT_ASSERT_EQUAL(std::string("/a/b"), path.str());
 	CPPUNIT_ASSERT(path.abs());
 }
+
+void RulesBaseUnit::quoting()
+{
+	RulesUnix	rules;
+	Canonical	canon = rules.canonical("/a/b");
+
+	CPPUNIT_ASSERT(canon.plain() == &rules);
+	canon.add("c");
+	CPPUNIT_ASSERT(canon.plain() == &rules);
+	CPPUNIT_ASSERT_EQUAL(std::string("/a/b/c"), rules.str(canon));
+
+	// A component with the seperator is quoted
+	canon.add("d/e");
+	CPPUNIT_ASSERT(canon.plain() == 0);
+	CPPUNIT_ASSERT_EQUAL(std::string("/a/b/c/d_!_e"), rules.str(canon));
+
+	canon = rules.canonical("x");
+	canon.extendLast("/y");
+	CPPUNIT_ASSERT(canon.plain() == 0);
+	CPPUNIT_ASSERT_EQUAL(std::string("x_!_y"), rules.str(canon));
+
+	// Protocol, host and drive
+	Canonical	uri;
+	uri.setProtocol("http").setHost("peteware.com").setDrive("C").setAbs(true);
+	uri.add("a");
+	CPPUNIT_ASSERT_EQUAL(std::string("http://peteware.com/C:/a"), rules.str(uri));
+}
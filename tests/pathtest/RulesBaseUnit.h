@@ -14,6 +14,7 @@ class RulesBaseUnit: public CppUnit::TestCase
 	CPPUNIT_TEST(init);
 	CPPUNIT_TEST(canonical);
 	CPPUNIT_TEST(convert);
+	CPPUNIT_TEST(quoting);
     
 	CPPUNIT_TEST_SUITE_END();
 public:
@@ -32,4 +33,6 @@ protected:
 	void canonical();
 	/// Test conversion to Path form
 	void convert();
+	/// Test str() quotes components and Canonical::plain()
+	void quoting();
 };
@@ -4,8 +4,15 @@
  */
 #include <path/SysBase.h>
 #include <path/PathException.h>
+#include <path/NodeInfo.h>
 
 #include <stdlib.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <string>
+#include <vector>
 
 #include <cppunit/TestCase.h>
 #include <cppunit/extensions/HelperMacros.h>
@@ -18,6 +25,10 @@ class SysBaseUnit: public CppUnit::TestCase
 
 	CPPUNIT_TEST(init);
 	CPPUNIT_TEST(listdir);
+	CPPUNIT_TEST(readdir);
+	CPPUNIT_TEST(sort);
+	CPPUNIT_TEST(stat);
+	CPPUNIT_TEST(at);
     CPPUNIT_TEST(mkdir);
     CPPUNIT_TEST_EXCEPTION(mkdir_fail, PathException);
     CPPUNIT_TEST_EXCEPTION(rmdir_fail, PathException);
@@ -29,6 +40,14 @@ protected:
 	void init();
 	/// Test listing a directory
 	void listdir();
+	/// Test readdir() returns types and inodes
+	void readdir();
+	/// Test sorting DirEntries
+	void sort();
+	/// Test stat() with fields and without following links
+	void stat();
+	/// Test the calls relative to an open directory
+	void at();
     /// Test create a directory
     void mkdir();
     /// Test that mkdir raises the correct exception
@@ -56,6 +75,138 @@ void SysBaseUnit::listdir()
 	
 }
 
+void SysBaseUnit::readdir()
+{
+    System.mkdir("rd");
+    System.mkdir("rd/sub");
+    FILE    *fp = fopen("rd/file", "w");
+    CPPUNIT_ASSERT(fp != 0);
+    fclose(fp);
+
+    DirEntries  entries;
+    CPPUNIT_ASSERT(System.readdir("rd", entries));
+    CPPUNIT_ASSERT_EQUAL(size_t(2), entries.size());
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+        DirEntry    entry = entries[i];
+        struct stat st;
+        CPPUNIT_ASSERT(entry.name == "file" || entry.name == "sub");
+        CPPUNIT_ASSERT_EQUAL(0, ::stat(("rd/" + std::string(entry.name)).c_str(), &st));
+        CPPUNIT_ASSERT_EQUAL(uint64_t(st.st_ino), entry.inode);
+        if (entry.name == "sub")
+            CPPUNIT_ASSERT(entry.type == NodeInfo::DIRECTORY || entry.type == NodeInfo::UNKNOWN);
+        else
+            CPPUNIT_ASSERT(entry.type == NodeInfo::FILE || entry.type == NodeInfo::UNKNOWN);
+    }
+
+    // the buffer is reused
+    CPPUNIT_ASSERT(System.readdir("rd/sub", entries));
+    CPPUNIT_ASSERT(entries.empty());
+    CPPUNIT_ASSERT(!System.readdir("does not exist!", entries));
+
+    ::remove("rd/file");
+    System.rmdir("rd/sub");
+    System.rmdir("rd");
+}
+
+void SysBaseUnit::sort()
+{
+    DirEntries  entries;
+    std::vector<std::string> names;
+    // Enough sharing a long prefix for the radix sort to recurse
+    for (int i = 0; i < 300; ++i)
+        names.push_back("a_common_prefix_" + std::to_string(i * 7919 % 1000));
+    const char *others[] = { "b", "a", "\xff", "A", "a_common", "a_common_prefix_" };
+    names.insert(names.end(), others, others + 6);
+    for (size_t i = 0; i < names.size(); ++i)
+        entries.add(names[i], NodeInfo::FILE, 0);
+
+    std::vector<size_t> order;
+    entries.sort(order, DirEntries::UNSORTED);
+    CPPUNIT_ASSERT_EQUAL(names.size(), order.size());
+    for (size_t i = 0; i < order.size(); ++i)
+        CPPUNIT_ASSERT_EQUAL(i, order[i]);
+
+    entries.sort(order, DirEntries::BYTEWISE);
+    std::vector<std::string> sorted(names);
+    std::sort(sorted.begin(), sorted.end());
+    CPPUNIT_ASSERT_EQUAL(names.size(), order.size());
+    for (size_t i = 0; i < order.size(); ++i)
+        CPPUNIT_ASSERT_EQUAL(sorted[i], std::string(entries[order[i]].name));
+
+    DirEntries  versions;
+    const char *natural[] = { "file", "file1", "file01", "file2", "file9", "file10",
+                              "file10a", "file10b", "file100", "v1.2.9", "v1.2.10", "v1.10.0" };
+    for (int i = 11; i >= 0; --i)
+        versions.add(natural[i], NodeInfo::FILE, 0);
+    versions.sort(order, DirEntries::NATURAL);
+    for (size_t i = 0; i < order.size(); ++i)
+        CPPUNIT_ASSERT_EQUAL(std::string(natural[i]), std::string(versions[order[i]].name));
+}
+
+void SysBaseUnit::stat()
+{
+    FILE    *fp = fopen("st_file", "w");
+    CPPUNIT_ASSERT(fp != 0);
+    fputs("hello", fp);
+    fclose(fp);
+    CPPUNIT_ASSERT_EQUAL(0, ::symlink("st_file", "st_link"));
+
+    struct stat st;
+    CPPUNIT_ASSERT_EQUAL(0, ::stat("st_file", &st));
+
+    NodeInfo    *info = System.stat("st_link");
+    CPPUNIT_ASSERT(info->has(NodeInfo::BASIC | NodeInfo::MTIME | NodeInfo::INODE));
+    CPPUNIT_ASSERT_EQUAL(NodeInfo::FILE, info->type());
+    CPPUNIT_ASSERT_EQUAL(off_t(5), info->size());
+    CPPUNIT_ASSERT_EQUAL(uint64_t(st.st_ino), info->inode());
+    CPPUNIT_ASSERT_EQUAL(uint64_t(st.st_dev), info->dev());
+    CPPUNIT_ASSERT_EQUAL(uint64_t(1), info->nlink());
+    CPPUNIT_ASSERT_EQUAL(st.st_uid, info->uid());
+    CPPUNIT_ASSERT_EQUAL(mode_t(st.st_mode & 07777), info->mode());
+    CPPUNIT_ASSERT_EQUAL(st.st_mtim.tv_sec, info->mtime().tv_sec);
+    CPPUNIT_ASSERT_EQUAL(st.st_mtim.tv_nsec, info->mtime().tv_nsec);
+    delete info;
+
+    info = System.stat("st_link", NodeInfo::TYPE, false);
+    CPPUNIT_ASSERT(info->has(NodeInfo::TYPE));
+    CPPUNIT_ASSERT_EQUAL(NodeInfo::SYMLINK, info->type());
+    delete info;
+
+    ::remove("st_link");
+    ::remove("st_file");
+}
+
+void SysBaseUnit::at()
+{
+    System.mkdir("at");
+    System.mkdir("at/sub");
+    System.touch("at/sub/file");
+
+    int     top = System.opendir("at");
+    CPPUNIT_ASSERT(top >= 0);
+    int     sub = System.opendirat(top, "sub");
+    CPPUNIT_ASSERT(sub >= 0);
+    CPPUNIT_ASSERT_EQUAL(-1, System.opendirat(sub, "file"));
+
+    DirEntries  entries;
+    CPPUNIT_ASSERT(System.readdir(sub, entries));
+    CPPUNIT_ASSERT_EQUAL(size_t(1), entries.size());
+    CPPUNIT_ASSERT(entries[0].name == "file");
+
+    NodeInfo    *info = System.statat(sub, entries[0].name.data(), NodeInfo::TYPE);
+    CPPUNIT_ASSERT_EQUAL(NodeInfo::FILE, info->type());
+    delete info;
+
+    System.removeat(sub, "file");
+    CPPUNIT_ASSERT(!System.exists("at/sub/file"));
+    System.closedir(sub);
+    System.removeat(top, "sub", true);
+    CPPUNIT_ASSERT(!System.exists("at/sub"));
+    System.closedir(top);
+    System.rmdir("at");
+}
+
 void SysBaseUnit::mkdir()
 {
     System.mkdir("xxx");